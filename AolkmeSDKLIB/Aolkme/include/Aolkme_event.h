@@ -27,6 +27,18 @@ extern "C" {
 
 #define     MAX_EVENT_SYSTEM_HANDLERS           16
 #define     MAX_EVENT_SYSTEM_QUEUE_SIZE         32
+#define     MAX_EVENT_SYSTEM_ISR_QUEUE_SIZE     8       // Events pending from interrupts
+#define     MAX_EVENT_SYSTEM_PRIORITY_LANES     8       // Priorities carried in T_AolkmeEvent.flags
+#define     MAX_EVENT_SYSTEM_COALESCE_IDS       8       // Event IDs with coalescing enabled
+#define     MAX_EVENT_SYSTEM_COALESCE_SLOTS     8       // Coalesced ID/source pairs pending at once
+#define     MAX_EVENT_SYSTEM_WORKERS            4       // Event tasks dispatching in parallel
+#define     MAX_EVENT_SYSTEM_DISPATCH_BATCH     8       // Events dequeued per mutex acquisition (on the event task stack)
+#define     MAX_EVENT_SYSTEM_TIMERS             16      // Delayed/periodic events armed at once (max 255)
+#define     MAX_EVENT_SYSTEM_REPLY_SLOTS        4       // AolkmeEvent_Request calls waiting at once (max 255)
+#define     MAX_EVENT_SYSTEM_STICKY_IDS         8       // Event IDs whose last event is kept (AolkmeEvent_SetSticky)
+#define     MAX_EVENT_SYSTEM_BACKPRESSURE_IDS   8       // Event IDs with their own full-queue policy (AolkmeEvent_SetBackpressure)
+#define     MAX_EVENT_SYSTEM_ROUTE_MASKS        4       // Distinct non-prefix masks subscribed at once (AolkmeEvent_SubscribeEventMask)
+#define     AOLKME_EVENT_LATENCY_BUCKETS        20      // log2 us buckets, the last one holds >= 2^18 us
 
 
 
@@ -35,6 +47,22 @@ extern "C" {
 typedef uint32_t E_AolkmeEventID;
 
 
+#define     AOLKME_EVENT_ID_MIN                 0x00000000u
+#define     AOLKME_EVENT_ID_MAX                 0xFFFFFFFFu
+
+/**
+ * @brief Category of an event ID (upper 16 bits, e.g. 0x0001 system, 0x0002 network).
+ */
+#define     AOLKME_EVENT_CATEGORY(id)           ((uint32_t)(id) >> 16)
+
+/**
+ * @brief Mask and value subscribing to a whole category, e.g. every sensor event:
+ *   AolkmeEvent_SubscribeEventMaskRef(AOLKME_EVENT_CATEGORY_MASK, AOLKME_EVENT_CATEGORY_BASE(AOLKME_EVENT_CATEGORY_SENSOR), handler)
+ */
+#define     AOLKME_EVENT_CATEGORY_MASK          0xFFFF0000u
+#define     AOLKME_EVENT_CATEGORY_BASE(category) ((E_AolkmeEventID)(category) << 16)
+
+
 typedef struct {
     E_AolkmeEventID                 ID;                   // !> Event ID
     uint32_t                        timestamp;            // !> Event timestamp
@@ -43,6 +71,7 @@ typedef struct {
     size_t                          data_size;            // !> Event size
     const char*                     name;                 // !> Event name
     uint8_t                         flags;                // !> Event flags (e.g., priority, persistence)
+    uint32_t                        reply;                // !> Reply slot of a request (AolkmeEvent_Request), 0: not a request
 } T_AolkmeEvent;
 
 
@@ -56,36 +85,521 @@ typedef struct {
  */
 typedef void (*AolkmeEventHandler)(T_AolkmeEvent event);
 
+/**
+ * @brief Event callback function type, event passed by reference.
+ *
+ * The event is only valid for the duration of the call; copy it, or AolkmeEvent_SharedRetain
+ * a shared payload, to keep it longer. Preferred over AolkmeEventHandler, which copies the
+ * whole event for every handler call.
+ */
+typedef void (*AolkmeEventRefHandler)(const T_AolkmeEvent* event);
+
+
+/**
+ * @brief Subscription fixed at build time, see T_AolkmeEventSystemConfig.static_routes.
+ */
+typedef struct {
+    E_AolkmeEventID first;        // !> First event ID
+    E_AolkmeEventID last;         // !> Last event ID (inclusive)
+    AolkmeEventRefHandler handler; // !> Handler
+} T_AolkmeEventStaticRoute;
+
+/**
+ * @brief Entries of a static route table, kept const so that it stays in flash:
+ *
+ *   static const T_AolkmeEventStaticRoute s_routes[] = {
+ *       AOLKME_EVENT_STATIC_ROUTE(AOLKME_EVENT_SYSTEM_HEARTBEAT, OnHeartbeat),
+ *       AOLKME_EVENT_STATIC_ROUTE_RANGE(AOLKME_EVENT_SENSOR_DATA_READY, AOLKME_EVENT_SENSOR_CALIBRATION, OnSensor),
+ *   };
+ *   config.static_routes = s_routes;
+ *   config.static_route_count = AOLKME_EVENT_STATIC_ROUTE_COUNT(s_routes);
+ *
+ * Entries must be sorted by first ID, AolkmeEvent_Init rejects the table otherwise.
+ */
+#define AOLKME_EVENT_STATIC_ROUTE(id, handler)                  { (id), (id), (handler) }
+#define AOLKME_EVENT_STATIC_ROUTE_RANGE(first, last, handler)   { (first), (last), (handler) }
+#define AOLKME_EVENT_STATIC_ROUTE_COUNT(table)                  ((uint16_t)(sizeof(table) / sizeof((table)[0])))
+
+
+/**
+ * @brief Delayed or periodic event, returned by AolkmeEvent_PublishDelayed/PublishPeriodic.
+ */
+typedef uint32_t T_AolkmeEventTimerHandle;
+
+
+/**
+ * @brief Event queue implementation.
+ */
+typedef enum {
+    AOLKME_EVENT_QUEUE_MUTEX    = 0,  // !> Ring protected by the event system mutex
+    AOLKME_EVENT_QUEUE_LOCKFREE = 1,  // !> Lock-free multi-producer/single-consumer ring
+} E_AolkmeEventQueueMode;
+
+
+/**
+ * @brief What a publish does when the lane of the event is full.
+ *
+ * Except for REJECT, the event system owns the payload once the event is published: the
+ * payload of every event it drops, queued or new, is freed like after dispatch.
+ */
+typedef enum {
+    AOLKME_EVENT_BACKPRESSURE_REJECT       = 0,  // !> Return EVENT_QUEUE_FULL, the caller keeps the payload (default)
+    AOLKME_EVENT_BACKPRESSURE_BLOCK        = 1,  // !> Wait up to timeout_ms for a free slot, then drop the new event
+    AOLKME_EVENT_BACKPRESSURE_DROP_OLDEST  = 2,  // !> Evict the oldest queued event of the lane
+    AOLKME_EVENT_BACKPRESSURE_DROP_NEWEST  = 3,  // !> Drop the new event
+    AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST  = 4,  // !> Evict the lowest-priority queued event of the lane if below the new one, else drop the new one
+} E_AolkmeEventBackpressure;
+
+#define     AOLKME_EVENT_WAIT_FOREVER           0xFFFFFFFFu     // timeout_ms of AOLKME_EVENT_BACKPRESSURE_BLOCK
+
+
+/**
+ * @brief One size class of the event payload pool.
+ */
+typedef struct {
+    uint16_t block_size;          // !> Payload bytes per block (rounded up to 8)
+    uint16_t block_count;         // !> Number of blocks
+} T_AolkmeEventPoolConfig;
+
 
 /**
  * @brief Event system configuration structure.
  */
 typedef struct {
-    uint16_t queue_size;          // !> Size of the event queue
+    uint16_t queue_size;          // !> Size of each lane's queue per worker (holds queue_size - 1 events)
     uint16_t task_stack_size;     // !> Event task stack size
     uint8_t task_priority;        // !> Event task priority
-    uint8_t max_handlers;         // !> Maximum number of event handlers
+    uint8_t max_handlers;         // !> Maximum number of runtime subscriptions (routes), may be 0 with static_routes
     bool enable_auto_processing;  // !> Enable automatic event processing
+    uint8_t queue_mode;           // !> E_AolkmeEventQueueMode
+
+    uint8_t priority_lanes;       // !> Number of priority lanes, 0 or 1 for a single FIFO
+    const uint16_t* lane_queue_sizes; // !> Optional queue size per lane (index = priority), NULL: queue_size
+    const uint8_t* lane_weights;  // !> Optional dequeue weight per lane, NULL: strict priority
 
-    uint8_t reserved[2];          // !> Reserved for future use, must be zero
+    const T_AolkmeEventPoolConfig* pools; // !> Optional payload pool size classes, ascending block_size
+    uint8_t pool_count;           // !> Number of entries in pools
+
+    uint8_t worker_count;         // !> Event tasks, 0 or 1 for one; each ID always goes to the same task
+    const int8_t* worker_cores;   // !> Optional core per worker (needs OSAL TaskCreatePinned), -1: any core
+
+    uint16_t trace_size;          // !> Trace ring records (rounded up to a power of two), recording from init, 0: no trace
+
+    const T_AolkmeEventStaticRoute* static_routes; // !> Optional subscriptions fixed at build time, sorted by first ID
+    uint16_t static_route_count;  // !> Entries in static_routes
 } T_AolkmeEventSystemConfig;
 
 
+/**
+ * @brief Status of one payload pool size class.
+ */
+typedef struct {
+    uint16_t block_size;          // !> Payload bytes per block
+    uint16_t block_count;         // !> Number of blocks
+    uint16_t in_use;              // !> Blocks currently allocated
+    uint16_t high_water;          // !> Maximum of in_use since init
+    uint32_t alloc_failures;      // !> Allocations that fitted this class but found no free block
+} T_AolkmeEventPoolStatus;
+
+
+/**
+ * @brief Event system counters, see AolkmeEvent_GetStats().
+ */
+typedef struct {
+    uint32_t publish_count;       // !> Events accepted by PublishEvent / PublishEventFromISR
+    uint32_t dispatch_count;      // !> Events handed to the handlers
+    uint32_t drop_queue_full;     // !> Publishes rejected because their lane was full
+    uint32_t drop_isr_queue_full; // !> Interrupt publishes rejected because the interrupt ring was full
+    uint32_t drop_invalid;        // !> Publishes rejected as invalid (e.g. reserved flags set)
+    uint32_t drop_block_timeout;  // !> Events dropped by AOLKME_EVENT_BACKPRESSURE_BLOCK (timed out)
+    uint32_t drop_oldest;         // !> Events dropped by AOLKME_EVENT_BACKPRESSURE_DROP_OLDEST
+    uint32_t drop_newest;         // !> Events dropped by AOLKME_EVENT_BACKPRESSURE_DROP_NEWEST
+    uint32_t drop_lowest_priority; // !> Events dropped by AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST, queued or new
+    uint32_t coalesced_count;     // !> Events replaced in place by a newer one
+    uint32_t queue_depth;         // !> Events currently queued
+    uint32_t peak_queue_depth;    // !> Maximum of queue_depth
+    uint32_t latency_histogram[AOLKME_EVENT_LATENCY_BUCKETS]; // !> Publish to dispatch, [0]: 0 us, [n]: [2^(n-1), 2^n) us
+} T_AolkmeEventStats;
+
+
+/**
+ * @brief Execution time of one handler, see AolkmeEvent_GetHandlerStats().
+ */
+typedef struct {
+    AolkmeEventRefHandler handler;       // !> By-reference handler, or NULL
+    AolkmeEventHandler value_handler;    // !> By-value handler, or NULL
+    uint32_t call_count;          // !> Calls
+    uint32_t total_time_us;       // !> Cumulative execution time (wraps)
+    uint32_t max_time_us;         // !> Longest single call
+} T_AolkmeEventHandlerStats;
+
+
+/**
+ * @brief One dispatched event in the trace ring, see AolkmeEvent_TraceDump().
+ *
+ * Dumped as is (20 bytes, native byte order, little endian on all supported targets).
+ */
+typedef struct {
+    uint32_t ID;                  // !> Event ID
+    uint32_t timestamp;           // !> Publish time, ms
+    uint32_t source;              // !> Low 32 bits of the event source pointer
+    uint32_t data_size;           // !> Payload size (the payload itself is not recorded)
+    uint32_t dispatch_us;         // !> Time spent in all handlers of the event
+} T_AolkmeEventTraceRecord;
+
+
+/**
+ * @brief Trace dump header, followed by record_count T_AolkmeEventTraceRecord, oldest first.
+ */
+typedef struct {
+    uint32_t magic;               // !> AOLKME_EVENT_TRACE_MAGIC
+    uint16_t version;             // !> AOLKME_EVENT_TRACE_VERSION
+    uint16_t record_size;         // !> sizeof(T_AolkmeEventTraceRecord)
+    uint32_t record_count;        // !> Records following the header
+    uint32_t lost_count;          // !> Records overwritten before this dump
+} T_AolkmeEventTraceHeader;
+
+#define     AOLKME_EVENT_TRACE_MAGIC            0x52544541u     // "AETR"
+#define     AOLKME_EVENT_TRACE_VERSION          1
+
+/**
+ * @brief Sink for AolkmeEvent_TraceDump(), same signature as a logger console output
+ * (ConsoleOutputFunc), so a UART output registered with the logger can be passed directly.
+ */
+typedef T_AolkmeReturnCode (*AolkmeEventTraceWriter)(const uint8_t* data, uint16_t len);
+
+
+/**
+ * @brief Status of one priority lane.
+ */
+typedef struct {
+    uint16_t capacity;            // !> Maximum number of queued events
+    uint16_t count;               // !> Currently queued events
+    uint32_t overflow_count;      // !> Publishes that found the lane full (whatever their backpressure policy)
+    uint32_t coalesced_count;     // !> Events replaced in place by a newer one (AolkmeEvent_SetCoalesce)
+} T_AolkmeEventLaneStatus;
+
+
 
 T_AolkmeReturnCode AolkmeEvent_Init(const T_AolkmeEventSystemConfig* config);
 
 T_AolkmeReturnCode AolkmeEvent_Deinit(void);
 
+/**
+ * @brief Publish an event, applying the backpressure policy of its ID (AolkmeEvent_SetBackpressure)
+ * when its lane is full.
+ *
+ * When the event system drops the event, a dynamic or shared payload is freed and event->data
+ * is set to NULL, so a caller that frees the payload on failure does nothing twice.
+ *
+ * @return T_AolkmeReturnCode EVENT_QUEUE_FULL if the event was rejected or dropped, SYSTEM
+ *         TIMEOUT if AOLKME_EVENT_BACKPRESSURE_BLOCK gave up
+ */
 T_AolkmeReturnCode AolkmeEvent_PublishEvent(T_AolkmeEvent* event);
 
+/**
+ * @brief Publish an event with an explicit backpressure policy, overriding the one of its ID.
+ *
+ * @param event
+ * @param policy E_AolkmeEventBackpressure
+ * @param timeout_ms Wait of AOLKME_EVENT_BACKPRESSURE_BLOCK, AOLKME_EVENT_WAIT_FOREVER for no limit
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishEventPolicy(T_AolkmeEvent* event, E_AolkmeEventBackpressure policy, uint32_t timeout_ms);
+
+/**
+ * @brief Publish an event from an interrupt handler.
+ *
+ * Takes no lock and never blocks. event->timestamp is kept as given (fill it from an ISR-safe
+ * tick source, e.g. HAL_GetTick()); if it is zero the event task stamps it when dequeuing.
+ * The event task is woken through SemaPostFromISR of the OSAL handler; without it, the event
+ * is picked up on the next poll of the event task (at most 100 ms).
+ *
+ * @param event Event to publish
+ * @param context_switch_required Set to true if the caller must yield on ISR exit
+ *        (e.g. portYIELD_FROM_ISR()), may be NULL
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishEventFromISR(T_AolkmeEvent* event, bool* context_switch_required);
+
+/**
+ * @brief Subscribe to all events. The handler must filter on event.ID itself.
+ */
 T_AolkmeReturnCode AolkmeEvent_SubscribeEvent(AolkmeEventHandler handler);
 
+/**
+ * @brief Unsubscribe a handler from every ID and range it is subscribed to.
+ */
 T_AolkmeReturnCode AolkmeEvent_UnsubscribeEvent(AolkmeEventHandler handler);
 
+/**
+ * @brief Subscribe to a single event ID. The handler is only called for this ID.
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventId(E_AolkmeEventID id, AolkmeEventHandler handler);
+
+/**
+ * @brief Subscribe to every event ID in [first, last].
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventRange(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventHandler handler);
+
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventId(E_AolkmeEventID id, AolkmeEventHandler handler);
+
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventRange(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventHandler handler);
+
+/**
+ * @brief Subscribe to every event ID with (ID & mask) == value.
+ *
+ * A mask of leading ones (e.g. AOLKME_EVENT_CATEGORY_MASK) is stored as the equivalent range
+ * and costs nothing extra. Other masks are looked up at dispatch with one AND and one binary
+ * search per distinct mask; at most MAX_EVENT_SYSTEM_ROUTE_MASKS distinct ones at a time.
+ *
+ * @param mask
+ * @param value Must not have bits outside mask
+ * @param handler
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventMask(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventHandler handler);
+
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventMask(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventHandler handler);
+
+/**
+ * @brief By-reference variants of the subscribe functions above.
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventRef(AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventIdRef(E_AolkmeEventID id, AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventRangeRef(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventRef(AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventIdRef(E_AolkmeEventID id, AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventRangeRef(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventMaskRef(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventRefHandler handler);
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventMaskRef(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventRefHandler handler);
+
 
 
 T_AolkmeReturnCode AolkmeEvent_GetStatus(uint8_t* queue_usage, uint8_t* handler_count);
 
+/**
+ * @brief Get the status of one priority lane.
+ */
+T_AolkmeReturnCode AolkmeEvent_GetLaneStatus(uint8_t lane, T_AolkmeEventLaneStatus* status);
+
+/**
+ * @brief Get publish/drop counters, queue depth and the publish-to-dispatch latency histogram.
+ *
+ * Latency is measured from the timestamp stamped by AolkmeEvent_PublishEvent, so its
+ * resolution is that of the OSAL GetTimeMs; interrupt events are stamped at dispatch and
+ * count as 0 us. Handler times use GetTimeUs when the OSAL provides it.
+ */
+T_AolkmeReturnCode AolkmeEvent_GetStats(T_AolkmeEventStats* stats);
+
+/**
+ * @brief Get the execution time of handler index (0 .. number of handlers ever subscribed - 1).
+ */
+T_AolkmeReturnCode AolkmeEvent_GetHandlerStats(uint16_t index, T_AolkmeEventHandlerStats* stats);
+
+/**
+ * @brief Zero the counters returned by AolkmeEvent_GetStats() and AolkmeEvent_GetHandlerStats().
+ */
+T_AolkmeReturnCode AolkmeEvent_ResetStats(void);
+
+/**
+ * @brief Publish an event ID last-value-wins.
+ *
+ * While an event of this ID is still queued, a newer one from the same source and with the
+ * same priority replaces it in place (its payload is freed) instead of taking another queue
+ * slot, so a high-rate ID holds at most one slot per source and priority. Events published
+ * from interrupts are never coalesced.
+ *
+ * Pending coalesced events are guarded by the event mutex, also in AOLKME_EVENT_QUEUE_LOCKFREE
+ * mode: publishing a coalesced ID, and dequeuing it, takes the mutex there.
+ *
+ * @param id
+ * @param enable
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SetCoalesce(E_AolkmeEventID id, bool enable);
+
+/**
+ * @brief Set what AolkmeEvent_PublishEvent does with events of id when their lane is full.
+ *
+ * DROP_OLDEST and DROP_LOWEST evict from the lane of the new event (its priority lane on its
+ * worker). In AOLKME_EVENT_QUEUE_LOCKFREE mode DROP_LOWEST only looks at the oldest queued
+ * event, the lock-free ring cannot be compacted. An evicted request times out on its
+ * requester. BLOCK must not be used for IDs published by the handlers of the event task
+ * that dispatches them: it would wait for itself until the timeout. Timers never block, they
+ * drop the occurrence instead. Interrupt publishes keep their own ring and never apply a policy.
+ *
+ * @param id
+ * @param policy AOLKME_EVENT_BACKPRESSURE_REJECT removes the rule of id
+ * @param timeout_ms Wait of AOLKME_EVENT_BACKPRESSURE_BLOCK, AOLKME_EVENT_WAIT_FOREVER for no limit
+ * @return T_AolkmeReturnCode OUT_OF_RESOURCES if MAX_EVENT_SYSTEM_BACKPRESSURE_IDS already have a rule
+ */
+T_AolkmeReturnCode AolkmeEvent_SetBackpressure(E_AolkmeEventID id, E_AolkmeEventBackpressure policy, uint32_t timeout_ms);
+
+/**
+ * @brief Keep the last dispatched event of an ID for late subscribers.
+ *
+ * A handler subscribing to a sticky ID (or a range holding one) gets the cached event right
+ * away, on the event task, before any newer event of that ID. AolkmeEvent_GetLast reads it
+ * without going through the queue. A shared payload is kept by reference, a dynamic one is
+ * copied into a shared payload (so it must not hold pointers into itself); other payloads
+ * are kept as a plain pointer and must stay valid, e.g. EVENT_FLAG_STATIC_DATA.
+ *
+ * @param id
+ * @param enable Disabling drops the cached event
+ * @return T_AolkmeReturnCode OUT_OF_RESOURCES if MAX_EVENT_SYSTEM_STICKY_IDS are already sticky
+ */
+T_AolkmeReturnCode AolkmeEvent_SetSticky(E_AolkmeEventID id, bool enable);
+
+/**
+ * @brief Get the last dispatched event of a sticky ID.
+ *
+ * A shared payload comes with a reference of its own: release it with
+ * AolkmeEvent_SharedRelease(event->data) when event->flags has EVENT_FLAG_SHARED_DATA.
+ *
+ * @param id
+ * @param event Set to a copy of the cached event
+ * @return T_AolkmeReturnCode NOT_SUPPORTED if id is not sticky, HANDLER_NOT_FOUND if no event
+ *         of id was dispatched yet
+ */
+T_AolkmeReturnCode AolkmeEvent_GetLast(E_AolkmeEventID id, T_AolkmeEvent* event);
+
+/**
+ * @brief Publish a copy of event once, delay_ms from now.
+ *
+ * Timers are kept in one min-heap run by the first event task, so they need
+ * enable_auto_processing. The timestamp is stamped when the event is actually published.
+ * A dynamic payload is freed after dispatch or on AolkmeEvent_CancelTimer.
+ *
+ * @param event Event to publish (copied)
+ * @param delay_ms
+ * @param handle Set to the timer handle, may be NULL
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishDelayed(const T_AolkmeEvent* event, uint32_t delay_ms, T_AolkmeEventTimerHandle* handle);
+
+/**
+ * @brief Publish a copy of event every period_ms until AolkmeEvent_CancelTimer.
+ *
+ * Replaces a task that only loops on a delay and publishes: each periodic producer costs one
+ * timer slot instead of a task and its stack. Periods are kept without drift; when the event
+ * task falls more than a period behind, the missed publishes are skipped. A full queue drops
+ * that single publish. EVENT_FLAG_DYNAMIC_DATA is rejected; a shared payload is retained for
+ * every publish and released on cancel.
+ *
+ * @param event Event to publish (copied)
+ * @param period_ms Period, > 0
+ * @param handle Set to the timer handle, may be NULL
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishPeriodic(const T_AolkmeEvent* event, uint32_t period_ms, T_AolkmeEventTimerHandle* handle);
+
+/**
+ * @brief Stop a delayed or periodic event.
+ */
+T_AolkmeReturnCode AolkmeEvent_CancelTimer(T_AolkmeEventTimerHandle handle);
+
+/**
+ * @brief Publish event as a request and wait until a handler answers it with AolkmeEvent_Reply.
+ *
+ * The reply is copied straight into response; the wait uses one of MAX_EVENT_SYSTEM_REPLY_SLOTS
+ * slots whose semaphores are created once in AolkmeEvent_Init, so a request allocates nothing.
+ * Must not be called from an event handler: the handler would wait for the task running it.
+ * Requests are never coalesced.
+ *
+ * @param event Request; event->reply is set while the request is pending and cleared on return
+ * @param response Buffer for the reply, may be NULL if *response_size is 0
+ * @param response_size In: size of response. Out: size of the reply. May be NULL for no reply data
+ * @param timeout_ms
+ * @return T_AolkmeReturnCode SYSTEM TIMEOUT if no reply came in time, OUT_OF_RESOURCES if all
+ *         reply slots are busy or the reply was truncated to fit response
+ */
+T_AolkmeReturnCode AolkmeEvent_Request(T_AolkmeEvent* event, void* response, size_t* response_size, uint32_t timeout_ms);
+
+/**
+ * @brief Answer a request, from a handler or later from any task.
+ *
+ * Only the first reply to a request is delivered.
+ *
+ * @param request The request event as received by the handler (or a copy of it)
+ * @param data Reply data, copied into the requester's buffer
+ * @param size
+ * @return T_AolkmeReturnCode HANDLER_NOT_FOUND if the request was already answered or timed out
+ */
+T_AolkmeReturnCode AolkmeEvent_Reply(const T_AolkmeEvent* request, const void* data, size_t size);
+
+/**
+ * @brief Start or stop recording dispatched events into the trace ring (config trace_size).
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceEnable(bool enable);
+
+/**
+ * @brief Forget all recorded events.
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceClear(void);
+
+/**
+ * @brief Write the records not dumped yet to write: a T_AolkmeEventTraceHeader, then the
+ * records, oldest first. Dumped records are dropped from the ring.
+ *
+ * Recording is paused while dumping; records overwritten since the last dump or clear are
+ * counted in lost_count.
+ *
+ * @param write Sink, called with chunks of at most 16 records
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceDump(AolkmeEventTraceWriter write);
+
+/**
+ * @brief Publish a trace dump again through AolkmeEvent_PublishEvent, e.g. on a host build.
+ *
+ * Each event is published with its recorded ID, source (as an integer) and data_size; a
+ * zero-filled shared payload of data_size stands in for the unrecorded data. The gaps
+ * between the recorded timestamps are kept, divided by speed; speed 0 publishes as fast as
+ * the queue accepts, waiting while it is full. Runs in the calling task.
+ *
+ * @param dump Header and records as written by AolkmeEvent_TraceDump()
+ * @param size Bytes in dump
+ * @param speed 1: original timing, n: n times faster, 0: no delays
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceReplay(const void* dump, uint32_t size, uint16_t speed);
+
+/**
+ * @brief Allocate an event payload from the fixed-block pool. O(1), safe from interrupts.
+ *
+ * Publish the payload with EVENT_FLAG_DYNAMIC_DATA: the event system returns it to the pool
+ * after dispatch. Falls back to the next larger size class when the fitting one is empty.
+ *
+ * @return Block of at least size bytes, NULL if no pool block is free
+ */
+void* AolkmeEvent_PoolAlloc(size_t size);
+
+/**
+ * @brief Return a payload to the pool, e.g. when publishing it failed.
+ */
+T_AolkmeReturnCode AolkmeEvent_PoolFree(void* data);
+
+/**
+ * @brief Get the status of one payload pool size class.
+ */
+T_AolkmeReturnCode AolkmeEvent_GetPoolStatus(uint8_t pool, T_AolkmeEventPoolStatus* status);
+
+/**
+ * @brief Allocate a reference-counted payload, reference count 1.
+ *
+ * Publish it with EVENT_FLAG_SHARED_DATA: the event system drops one reference after
+ * dispatch. A handler that keeps the payload calls AolkmeEvent_SharedRetain and later
+ * AolkmeEvent_SharedRelease; the payload is freed when the last reference is dropped.
+ * Taken from the payload pool when one is configured, otherwise from the heap.
+ *
+ * @return Payload of at least size bytes, NULL if out of memory
+ */
+void* AolkmeEvent_SharedAlloc(size_t size);
+
+/**
+ * @brief Take one more reference to a shared payload. Safe from interrupts.
+ */
+void AolkmeEvent_SharedRetain(void* data);
+
+/**
+ * @brief Drop one reference to a shared payload, freeing it on the last one.
+ */
+void AolkmeEvent_SharedRelease(void* data);
+
 
 
 
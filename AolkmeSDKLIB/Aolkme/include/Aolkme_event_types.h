@@ -12,6 +12,15 @@
 extern "C" {
 #endif
 
+/**
+ * @brief 事件类别（事件ID的高16位），配合 AOLKME_EVENT_CATEGORY_BASE 按类别订阅
+ */
+#define AOLKME_EVENT_CATEGORY_SYSTEM    0x0001  ///< 系统事件
+#define AOLKME_EVENT_CATEGORY_NETWORK   0x0002  ///< 网络事件
+#define AOLKME_EVENT_CATEGORY_SENSOR    0x0003  ///< 传感器事件
+#define AOLKME_EVENT_CATEGORY_POWER     0x0004  ///< 电源管理事件
+#define AOLKME_EVENT_CATEGORY_USER      0x8000  ///< 用户自定义事件（AOLKME_EVENT_USER_BASE）
+
 /**
  * @brief 系统级事件ID
  */
@@ -23,6 +32,7 @@ typedef enum {
     AOLKME_EVENT_SYSTEM_HEARTBEAT      = 0x00010004, ///< 系统心跳
     AOLKME_EVENT_SYSTEM_RESOURCE_LOW   = 0x00010005, ///< 系统资源不足
     AOLKME_EVENT_SYSTEM_MONITOR_REPORT = 0x00010006, ///< 系统监控报告
+    AOLKME_EVENT_SYSTEM_MONITOR_TICK   = 0x00010007, ///< 系统监控采样（周期定时事件）
 } E_AolkmeSystemEventId;
 
 /**
@@ -61,10 +71,25 @@ typedef enum {
 
 typedef enum {
     EVENT_FLAG_NONE          = 0x00000000, ///< 无标志
-    EVENT_FLAG_DYNAMIC_DATA  = 0x00000001, ///< 动态数据标志
+    EVENT_FLAG_DYNAMIC_DATA  = 0x00000001, ///< 动态数据标志（Malloc 或 AolkmeEvent_PoolAlloc 分配，分发后自动释放）
     EVENT_FLAG_STATIC_DATA   = 0x00000002, ///< 静态数据标志
+    EVENT_FLAG_SHARED_DATA   = 0x00000008, ///< 引用计数数据标志（AolkmeEvent_SharedAlloc 分配，分发后释放一个引用）
+    EVENT_FLAG_PRIORITY_MASK = 0x00000070, ///< 优先级（0 最低，7 最高）
+    EVENT_FLAG_RESERVED      = 0x00000080, ///< 事件系统内部使用，发布时不要设置
 } E_AolkmeEventFlags;
 
+#define EVENT_FLAG_PRIORITY_SHIFT       4
+
+/**
+ * @brief 事件优先级标志，例如 .flags = EVENT_FLAG_PRIORITY(7)
+ */
+#define EVENT_FLAG_PRIORITY(p)          ((uint8_t)(((p) << EVENT_FLAG_PRIORITY_SHIFT) & EVENT_FLAG_PRIORITY_MASK))
+
+/**
+ * @brief 从事件标志中取出优先级
+ */
+#define EVENT_FLAG_GET_PRIORITY(flags)  (((flags) & EVENT_FLAG_PRIORITY_MASK) >> EVENT_FLAG_PRIORITY_SHIFT)
+
 
 
 
@@ -26,10 +26,41 @@ extern "C" {
 #endif
 
 
+/**
+ * @brief Most verbose level compiled in, 0 (FATAL) .. 5 (TRACE). ALOG_* calls above it expand to
+ *        nothing: no call and no tag, file, function or format strings in the image.
+ */
+#ifndef AOLKME_LOGGER_COMPILE_LEVEL
+#define AOLKME_LOGGER_COMPILE_LEVEL     5
+#endif
+
+/**
+ * @brief Per module compile level: define it before the first #include in a source file,
+ *        e.g. #define AOLKME_LOGGER_LOCAL_LEVEL 2 keeps FATAL, ERROR and WARN in that file only.
+ */
+#ifndef AOLKME_LOGGER_LOCAL_LEVEL
+#define AOLKME_LOGGER_LOCAL_LEVEL       AOLKME_LOGGER_COMPILE_LEVEL
+#endif
+
+/**
+ * @brief 1: ALOG_* macros log deferred (binary) frames, see ALOG_DEFER. 0: formatted text.
+ */
+#ifndef AOLKME_LOGGER_DEFERRED
+#define AOLKME_LOGGER_DEFERRED          0
+#endif
+
+#define AOLKME_LOGGER_DEFER_MAX_ARGS    8                   // Argument words of one deferred log
+#define AOLKME_LOGGER_DEFER_MAGIC       0xA5                // First byte of a deferred frame
+#define AOLKME_LOGGER_DEFER_SECTION     ".aolkme_logstr"    // Call site strings, read from the ELF by the host
+
+#define AOLKME_LOGGER_BATCH_SIZE_DEFAULT    512             // batch_size used when the config leaves it 0
+
+
 /**
 * @brief The console method that needs to be registered.
 * @note  Before registering the console method, you need to test the methods that need to be registered to ensure
 *        that they can be used normally.
+* @note  One call may carry several complete log lines, up to the configured batch_size bytes.
 */
 typedef T_AolkmeReturnCode (*ConsoleOutputFunc)(const uint8_t *data, uint16_t dataLen);
 
@@ -46,16 +77,89 @@ typedef enum{
     AOLKME_LOGGER_CONSOLE_LOG_LEVEL_MAX                 // <! max（Maximum log level）
 } E_AolkmeLoggerConsoleLogLevel;
 
+/**
+ * @brief What a log call does when the record ring is full.
+ */
+typedef enum{
+    AOLKME_LOGGER_OVERFLOW_DROP = 0,                    // <! Drop the new log and count it (never blocks)
+    AOLKME_LOGGER_OVERFLOW_WAIT,                        // <! Wait up to overflow_wait_ms for the flush task to free room
+} E_AolkmeLoggerOverflow;
+
 /**
  * @brief Logger console content.
  */
 typedef struct 
 {
     E_AolkmeLoggerConsoleLogLevel level;                // <! Log level
-    uint16_t buffer_size;                               // <! Buffer size
+    uint16_t buffer_size;                               // <! Record ring size in bytes, N * AolkmeGetBlockSize() holds at least N logs
     bool isSupportColor;                                // <! Color support
+    E_AolkmeLoggerOverflow overflow;                    // <! Ring full behavior, default drop
+    uint32_t overflow_wait_ms;                          // <! AOLKME_LOGGER_OVERFLOW_WAIT timeout
+    uint16_t batch_size;                                // <! Largest chunk handed to an output in one call, 0: AOLKME_LOGGER_BATCH_SIZE_DEFAULT
 } T_AolkmeLoggerConfig;
 
+/**
+ * @brief Logger counters.
+ */
+typedef struct
+{
+    uint32_t log_count;                                 // <! Logs queued for output
+    uint32_t unlog_count;                               // <! Logs dropped, or filtered past the inline ALOG_* check
+    uint32_t drop_buffer_full;                          // <! Dropped because the record ring had no room
+    uint32_t truncated_count;                           // <! Logs cut to fit one record
+    uint16_t buffer_size;                               // <! Record ring size in bytes
+    uint16_t buffer_used;                               // <! Bytes reserved, queued or being output
+    uint16_t buffer_peak;                               // <! Highest buffer_used
+} T_AolkmeLoggerStats;
+
+
+
+/**
+ * @brief Deferred log frame as written to the outputs, native (little) endian.
+ *
+ * id is the address of the call site string "tag\0file:line\0format" in AOLKME_LOGGER_DEFER_SECTION.
+ */
+typedef struct
+{
+    uint8_t magic;                                      // <! AOLKME_LOGGER_DEFER_MAGIC
+    uint8_t level;                                      // <! E_AolkmeLoggerConsoleLogLevel
+    uint8_t argc;                                       // <! Words in args[]
+    uint8_t seq;                                        // <! Frame counter, a gap means frames were dropped
+    uint32_t id;                                        // <! Call site string address
+    uint32_t timestamp;                                 // <! ms
+    uint32_t args[];                                    // <! Arguments, converted to 32-bit words
+} T_AolkmeLoggerDeferFrame;
+
+
+
+/**
+ * @brief Start an asynchronous transfer (e.g. UART DMA) of data. The bytes stay untouched until
+ *        the driver reports completion with AolkmeLogger_SinkTxComplete.
+ */
+typedef T_AolkmeReturnCode (*AolkmeLoggerSinkTransmit)(const uint8_t *data, uint16_t dataLen);
+
+/**
+ * @brief Double buffered output: chunks are copied into one half while the other is transmitted.
+ *
+ * state is written by the writer and by AolkmeLogger_SinkTxComplete (interrupt), both with
+ * compare-and-swap. Counters may be read at any time.
+ */
+typedef struct
+{
+    uint8_t *buffer;                                    // <! Two halves of half_size bytes, DMA accessible
+    uint16_t half_size;                                 // <! Bytes per half
+    AolkmeLoggerSinkTransmit transmit;                  // <! Starts a transfer
+    uint32_t wait_ms;                                   // <! Longest wait for a free half, then the rest of the chunk is dropped
+    T_AolkmeSemaHandle done_sema;                       // <! Posted on completion while the writer waits
+    volatile uint32_t state;                            // <! Fill half << 31 | busy << 30 | bytes in the fill half
+    volatile uint32_t waiting;                          // <! Writer waiting for a free half
+    volatile uint32_t in_flight;                        // <! Bytes of the transfer on the wire
+    volatile uint32_t transfers;                        // <! Completed transfers
+    volatile uint32_t bytes_sent;                       // <! Bytes of the completed transfers
+    volatile uint32_t write_waits;                      // <! Writes that waited for a free half
+    volatile uint32_t dropped_bytes;                    // <! Bytes lost to a wait timeout or a failed transmit
+} T_AolkmeLoggerSink;
+
 
 
 /**
@@ -88,30 +192,164 @@ void AolkmeLogger_Output(E_AolkmeLoggerConsoleLogLevel level, const char *tag,
  */
 T_AolkmeReturnCode AolkmeLogger_RemoveOutput(ConsoleOutputFunc output_func);
 
+/**
+ * @brief Change the runtime log level.
+ */
+T_AolkmeReturnCode AolkmeLogger_SetLevel(E_AolkmeLoggerConsoleLogLevel level);
+
+/**
+ * @brief Runtime level + 1, 0 while the logger is not initialized. Read inline by the ALOG_*
+ *        macros so that a filtered log costs one compare instead of a call.
+ */
+extern volatile uint8_t g_aolkme_logger_threshold;
+
+#define AOLKME_LOGGER_ENABLED(level)    ((uint8_t)(level) < g_aolkme_logger_threshold)
+
 
+/**
+ * @brief Size of the largest log record, header included.
+ */
 size_t AolkmeGetBlockSize(void);
 
+/**
+ * @brief Get the logger counters.
+ */
+T_AolkmeReturnCode AolkmeLogger_GetStats(T_AolkmeLoggerStats *stats);
+
+/**
+ * @brief Deferred log output: record the call site string address and the argument words,
+ *        formatting is done on the host.
+ */
+void AolkmeLogger_OutputDeferred(E_AolkmeLoggerConsoleLogLevel level, const char *id, const uint32_t *args, uint32_t argc);
+
+/**
+ * @brief Set up a double buffered sink over buffer (size bytes, split in two halves).
+ *
+ * @param sink 
+ * @param buffer 
+ * @param size 
+ * @param transmit 
+ * @param wait_ms 
+ * @return T_AolkmeReturnCode 
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkInit(T_AolkmeLoggerSink *sink, uint8_t *buffer, uint32_t size,
+                                         AolkmeLoggerSinkTransmit transmit, uint32_t wait_ms);
+
+/**
+ * @brief Release the sink. The caller stops the writer and the transfers first.
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkDeinit(T_AolkmeLoggerSink *sink);
+
+/**
+ * @brief Queue data for transmission; waits only while both halves are busy.
+ * @note  One writer at a time: call it from the ConsoleOutputFunc registered with AolkmeLogger_AddOutput,
+ *        which the flush task calls.
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkWrite(T_AolkmeLoggerSink *sink, const uint8_t *data, uint16_t dataLen);
+
+/**
+ * @brief Wait up to timeout_ms until both halves are sent. Same caller rules as AolkmeLogger_SinkWrite.
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkFlush(T_AolkmeLoggerSink *sink, uint32_t timeout_ms);
+
+/**
+ * @brief Transfer done: start the filled half, if any. Call it from the TX complete interrupt.
+ *
+ * Uses no OSAL call except SemaPostFromISR, so it is safe in ISR context.
+ */
+void AolkmeLogger_SinkTxComplete(T_AolkmeLoggerSink *sink, bool *context_switch_required);
+
+
+/**
+ * @brief Place a constant string in AOLKME_LOGGER_DEFER_SECTION. The target never reads the
+ *        section, so the linker script may keep it out of flash (NOLOAD / INFO).
+ *        A %s argument of a deferred log is only printed if it points to such a string.
+ */
+#if defined(__GNUC__) || defined(__ARMCC_VERSION)
+#define AOLKME_LOGGER_DEFER_STR         __attribute__((section(AOLKME_LOGGER_DEFER_SECTION), used))
+#else
+#define AOLKME_LOGGER_DEFER_STR
+#endif
+
+#define AOLKME_LOGGER_STRINGIFY_(x)     #x
+#define AOLKME_LOGGER_STRINGIFY(x)      AOLKME_LOGGER_STRINGIFY_(x)
+
+/**
+ * @brief Deferred log: no formatting on the target, the host tool aolkme_log_decode rebuilds the text.
+ *
+ * tag and format must be string literals. Arguments are converted to 32-bit words, so use
+ * integers and chars (cast pointers to uintptr_t); floats are not supported.
+ */
+#define ALOG_DEFER(level, tag, format, ...) \
+    do { \
+        static const char AOLKME_LOGGER_DEFER_STR aolkme_log_str[] = \
+            tag "\0" __FILE__ ":" AOLKME_LOGGER_STRINGIFY(__LINE__) "\0" format; \
+        if (AOLKME_LOGGER_ENABLED(level)) { \
+            const uint32_t aolkme_log_args[] = { 0, ##__VA_ARGS__ }; \
+            (void)sizeof(char[(sizeof(aolkme_log_args) / sizeof(uint32_t) <= AOLKME_LOGGER_DEFER_MAX_ARGS + 1) ? 1 : -1]); \
+            AolkmeLogger_OutputDeferred(level, aolkme_log_str, aolkme_log_args + 1, \
+                                        sizeof(aolkme_log_args) / sizeof(uint32_t) - 1); \
+        } \
+    } while (0)
+
+
+/**
+ * @brief One log call site: deferred frame or formatted text, after the inline runtime level check.
+ */
+#if AOLKME_LOGGER_DEFERRED
+#define AOLKME_LOGGER_EMIT(level, tag, format, ...) \
+    ALOG_DEFER(level, tag, format, ##__VA_ARGS__)
+#else
+#define AOLKME_LOGGER_EMIT(level, tag, format, ...) \
+    do { \
+        if (AOLKME_LOGGER_ENABLED(level)) { \
+            AolkmeLogger_Output(level, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#endif // AOLKME_LOGGER_DEFERRED
+
+#define AOLKME_LOGGER_NONE()            do { } while (0)
+
+
 /**
  * @brief Log output macro
  */
 
-#define ALOG_FATAL(tag, format, ...) \
-    AolkmeLogger_Output(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_FATAL, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#if AOLKME_LOGGER_LOCAL_LEVEL >= 0
+#define ALOG_FATAL(tag, format, ...)    AOLKME_LOGGER_EMIT(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_FATAL, tag, format, ##__VA_ARGS__)
+#else
+#define ALOG_FATAL(tag, format, ...)    AOLKME_LOGGER_NONE()
+#endif
 
-#define ALOG_ERROR(tag, format, ...) \
-    AolkmeLogger_Output(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_ERROR, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#if AOLKME_LOGGER_LOCAL_LEVEL >= 1
+#define ALOG_ERROR(tag, format, ...)    AOLKME_LOGGER_EMIT(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_ERROR, tag, format, ##__VA_ARGS__)
+#else
+#define ALOG_ERROR(tag, format, ...)    AOLKME_LOGGER_NONE()
+#endif
 
-#define ALOG_WARN(tag, format, ...) \
-    AolkmeLogger_Output(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_WARN, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#if AOLKME_LOGGER_LOCAL_LEVEL >= 2
+#define ALOG_WARN(tag, format, ...)     AOLKME_LOGGER_EMIT(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_WARN, tag, format, ##__VA_ARGS__)
+#else
+#define ALOG_WARN(tag, format, ...)     AOLKME_LOGGER_NONE()
+#endif
 
-#define ALOG_INFO(tag, format, ...) \
-    AolkmeLogger_Output(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_INFO, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#if AOLKME_LOGGER_LOCAL_LEVEL >= 3
+#define ALOG_INFO(tag, format, ...)     AOLKME_LOGGER_EMIT(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_INFO, tag, format, ##__VA_ARGS__)
+#else
+#define ALOG_INFO(tag, format, ...)     AOLKME_LOGGER_NONE()
+#endif
 
-#define ALOG_DEBUG(tag, format, ...) \
-    AolkmeLogger_Output(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_DEBUG, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#if AOLKME_LOGGER_LOCAL_LEVEL >= 4
+#define ALOG_DEBUG(tag, format, ...)    AOLKME_LOGGER_EMIT(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_DEBUG, tag, format, ##__VA_ARGS__)
+#else
+#define ALOG_DEBUG(tag, format, ...)    AOLKME_LOGGER_NONE()
+#endif
 
-#define ALOG_TRACE(tag, format, ...) \
-    AolkmeLogger_Output(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_TRACE, tag, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#if AOLKME_LOGGER_LOCAL_LEVEL >= 5
+#define ALOG_TRACE(tag, format, ...)    AOLKME_LOGGER_EMIT(AOLKME_LOGGER_CONSOLE_LOG_LEVEL_TRACE, tag, format, ##__VA_ARGS__)
+#else
+#define ALOG_TRACE(tag, format, ...)    AOLKME_LOGGER_NONE()
+#endif
 
 
 
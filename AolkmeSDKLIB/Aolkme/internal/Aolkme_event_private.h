@@ -0,0 +1,672 @@
+/**
+ * @file Aolkme_event_private.h
+ * @brief 事件系统内部定义
+ *
+ * 注意：此头文件仅供事件组件内部使用
+ */
+
+
+
+
+#ifndef AOLKME_EVENT_PRIVATE_H
+#define AOLKME_EVENT_PRIVATE_H
+
+
+
+#include "Aolkme_event.h"
+#include "Aolkme_event_types.h"
+#include "Aolkme_atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/**
+ * @brief Value of dispatch_epoch while the event task is not reading a routing table.
+ */
+#define AOLKME_EVENT_EPOCH_IDLE         0xFFFFFFFFu
+
+/**
+ * @brief Queued event is a token for a coalesce slot (data points at the slot).
+ */
+#define EVENT_FLAG_COALESCED_TOKEN      EVENT_FLAG_RESERVED
+
+/**
+ * @brief Route without a handler stats entry (the stats table was full).
+ */
+#define AOLKME_EVENT_STATS_NONE         0xFFFFu
+
+/**
+ * @brief heap_index of a timer slot that is not armed.
+ */
+#define AOLKME_EVENT_TIMER_FREE         0xFFu
+
+/**
+ * @brief States of a reply slot.
+ */
+#define AOLKME_EVENT_REPLY_FREE         0u      ///< Not in use
+#define AOLKME_EVENT_REPLY_PENDING      1u      ///< Request published, waiting for a reply
+#define AOLKME_EVENT_REPLY_WRITING      2u      ///< A responder is copying its reply
+#define AOLKME_EVENT_REPLY_DONE         3u      ///< Reply complete, requester signalled
+
+
+
+/**
+ * @brief Slot of the lock-free event queue.
+ *
+ * sequence == position      : free, the producer claiming position may write it
+ * sequence == position + 1  : written, the consumer may read it
+ */
+typedef struct
+{
+    volatile uint32_t               sequence;                   ///< Position this slot is ready for
+    T_AolkmeEvent                   event;                      ///< Queued event
+} T_AolkmeEventQueueSlot;
+
+/**
+ * @brief Lock-free multi-producer ring.
+ *
+ * Read by the worker; a publisher evicting from a full lane (backpressure policy) also takes
+ * the oldest event, so positions are dequeued with compare-and-swap too.
+ */
+typedef struct
+{
+    T_AolkmeEventQueueSlot*         slots;                      ///< Slot array, power-of-two length
+    uint32_t                        slot_mask;                  ///< Slot count - 1
+    uint32_t                        limit;                      ///< Maximum number of queued events
+    volatile uint32_t               enqueue_pos;                ///< Next position claimed by a producer
+    volatile uint32_t               dequeue_pos;                ///< Next position read by the consumer or an evicting publisher
+} T_AolkmeEventRing;
+
+
+/**
+ * @brief One priority lane of the event queue.
+ */
+typedef struct
+{
+    T_AolkmeEvent*                  queue;                      ///< Mutex ring storage (AOLKME_EVENT_QUEUE_MUTEX)
+    uint16_t                        capacity;                   ///< Ring size, holds capacity - 1 events
+    uint16_t                        head;                       ///< Head pointer of the mutex ring
+    uint16_t                        tail;                       ///< Tail pointer of the mutex ring
+    T_AolkmeEventRing               ring;                       ///< Lock-free ring (AOLKME_EVENT_QUEUE_LOCKFREE)
+    uint8_t                         weight;                     ///< Events served per round, 0: strict priority
+    uint8_t                         credit;                     ///< Events left in the current round
+    volatile uint32_t               overflow_count;             ///< Publishes that found the lane full
+    volatile uint32_t               coalesced_count;            ///< Events replaced by a newer one of the same ID/source
+} T_AolkmeEventLane;
+
+
+/**
+ * @brief Latest pending event of one coalesced ID/source/priority. Guarded by the mutex,
+ *        in lock-free mode too.
+ */
+typedef struct
+{
+    bool                            pending;                    ///< A token for this slot is queued
+    T_AolkmeEvent                   event;                      ///< Event delivered when the token is dequeued
+} T_AolkmeEventCoalesceSlot;
+
+
+/**
+ * @brief One event task with its own queue partition.
+ *
+ * Each worker is the single consumer of its lanes and interrupt ring; an event ID always
+ * hashes to the same worker, so events of one ID are dispatched in publish order.
+ */
+typedef struct
+{
+    T_AolkmeSemaHandle              event_sem;                  ///< Signals events queued for this worker
+    T_AolkmeTaskHandle              task_handle;                ///< Worker task
+    T_AolkmeEventLane*              lanes;                      ///< Priority lanes, index = priority
+    T_AolkmeEventRing               isr_ring;                   ///< Events published from interrupts
+    volatile uint32_t               dispatch_epoch;             ///< Route epoch announced while dispatching
+    volatile uint32_t               queued;                     ///< Events queued for this worker (lets an idle pop skip the mutex)
+    T_AolkmeSemaHandle              space_sem;                  ///< Signals dequeued events to blocked publishers
+    volatile uint32_t               blocked;                    ///< Publishers waiting for a free slot (AOLKME_EVENT_BACKPRESSURE_BLOCK)
+} T_AolkmeEventWorker;
+
+
+/**
+ * @brief One size class of the payload pool.
+ *
+ * Free blocks form a stack linked by block index (stored in the block's first bytes).
+ * free_head packs a 16-bit ABA tag above the 16-bit index of the top block.
+ */
+typedef struct
+{
+    uint8_t*                        base;                       ///< First block
+    uint16_t                        block_size;                 ///< Bytes per block, multiple of 8
+    uint16_t                        block_count;                ///< Number of blocks
+    volatile uint32_t               free_head;                  ///< (tag << 16) | top block index
+    volatile uint32_t               in_use;                     ///< Blocks currently allocated
+    volatile uint32_t               high_water;                 ///< Maximum of in_use
+    volatile uint32_t               alloc_failures;             ///< Failed allocations of this class
+} T_AolkmeEventPool;
+
+
+/**
+ * @brief One routing entry: handler is called for every ID in [first, last], or for a mask
+ * route every ID with (ID & mask) == first.
+ *
+ * Exactly one of handler / value_handler is set.
+ */
+typedef struct
+{
+    E_AolkmeEventID                 first;                      ///< First event ID of the subscribed range, value of a mask route
+    E_AolkmeEventID                 last;                       ///< Last event ID of the subscribed range (inclusive)
+    E_AolkmeEventID                 mask;                       ///< Non-prefix mask of a mask route, 0 for a range
+    AolkmeEventRefHandler           handler;                    ///< Subscriber callback, event by reference
+    AolkmeEventHandler              value_handler;              ///< Legacy subscriber callback, event by value
+    uint16_t                        stats;                      ///< Index in handler_stats[], AOLKME_EVENT_STATS_NONE if untracked
+} T_AolkmeEventRoute;
+
+/**
+ * @brief First-level index: all routes of one ID category (upper 16 bits).
+ */
+typedef struct
+{
+    uint16_t                        category;                   ///< AOLKME_EVENT_CATEGORY() of the routes
+    uint16_t                        start;                      ///< Index of the first route in routes[]
+    uint16_t                        count;                      ///< Number of routes in this category
+} T_AolkmeEventCategoryIndex;
+
+/**
+ * @brief Mask routes sharing one mask, sorted by value.
+ */
+typedef struct
+{
+    E_AolkmeEventID                 mask;                       ///< Mask of the routes
+    uint16_t                        start;                      ///< Index of the first route in routes[]
+    uint16_t                        count;                      ///< Number of routes with this mask
+} T_AolkmeEventMaskIndex;
+
+/**
+ * @brief Immutable routing table snapshot.
+ *
+ * Subscribe/unsubscribe build a modified copy and publish it; the event task dispatches from
+ * whatever snapshot was current when it picked up the event, without holding the mutex.
+ * routes[0, local_count)                  : ranges inside one category, sorted by first
+ * routes[capacity - wide_count, capacity) : ranges spanning categories (incl. subscribe-all),
+ *                                           then the last mask_count are mask routes sorted by mask, value
+ */
+typedef struct T_AolkmeEventRouteTable
+{
+    struct T_AolkmeEventRouteTable* next_retired;               ///< Link in the retired list
+    uint32_t                        retire_epoch;               ///< Route epoch at which this table was replaced
+    T_AolkmeEventRoute*             routes;                     ///< Route storage (follows the header)
+    T_AolkmeEventCategoryIndex*     categories;                 ///< Category index, sorted by category
+    uint16_t                        capacity;                   ///< Maximum number of routes
+    uint16_t                        route_count;                ///< Number of registered routes
+    uint16_t                        local_count;                ///< Routes inside one category
+    uint16_t                        wide_count;                 ///< Routes spanning several categories
+    uint16_t                        category_count;             ///< Entries in categories[]
+    uint16_t                        mask_count;                 ///< Mask routes, the tail of the wide routes
+    uint8_t                         mask_index_count;           ///< Entries in masks[]
+    T_AolkmeEventMaskIndex          masks[MAX_EVENT_SYSTEM_ROUTE_MASKS]; ///< Mask index, sorted by mask
+} T_AolkmeEventRouteTable;
+
+
+/**
+ * @brief Execution time of one handler, shared by all of its routes.
+ */
+typedef struct
+{
+    AolkmeEventRefHandler           handler;                    ///< By-reference handler, or NULL
+    AolkmeEventHandler              value_handler;              ///< By-value handler, or NULL
+    volatile uint32_t               call_count;                 ///< Calls
+    volatile uint32_t               total_time_us;              ///< Cumulative execution time
+    volatile uint32_t               max_time_us;                ///< Longest single call
+} T_AolkmeEventHandlerStatsSlot;
+
+/**
+ * @brief Event system counters, updated atomically by publishers, interrupts and workers.
+ */
+typedef struct
+{
+    volatile uint32_t               publish_count;              ///< Accepted publishes
+    volatile uint32_t               dispatch_count;             ///< Dispatched events
+    volatile uint32_t               drop_queue_full;            ///< Rejected, lane full
+    volatile uint32_t               drop_isr_queue_full;        ///< Rejected, interrupt ring full
+    volatile uint32_t               drop_invalid;               ///< Rejected, invalid event
+    volatile uint32_t               drop_block_timeout;         ///< Dropped, BLOCK timed out
+    volatile uint32_t               drop_oldest;                ///< Evicted by DROP_OLDEST
+    volatile uint32_t               drop_newest;                ///< Dropped by DROP_NEWEST
+    volatile uint32_t               drop_lowest_priority;       ///< Evicted or dropped by DROP_LOWEST
+    volatile uint32_t               queue_depth;                ///< Events queued
+    volatile uint32_t               peak_queue_depth;           ///< Maximum of queue_depth
+    volatile uint32_t               latency_histogram[AOLKME_EVENT_LATENCY_BUCKETS]; ///< log2 us publish-to-dispatch latency
+} T_AolkmeEventCounters;
+
+
+/**
+ * @brief Delayed or periodic event, kept in a min-heap ordered by due_ms.
+ */
+typedef struct
+{
+    T_AolkmeEvent                   event;                      ///< Event to publish (copied)
+    uint32_t                        due_ms;                     ///< Next publish time (GetTimeMs)
+    uint32_t                        period_ms;                  ///< Re-arm interval, 0 for one-shot
+    uint16_t                        generation;                 ///< Bumped on every arm, makes stale handles fail
+    uint8_t                         heap_index;                 ///< Position in timer_heap[], AOLKME_EVENT_TIMER_FREE if unused
+} T_AolkmeEventTimer;
+
+
+/**
+ * @brief Reply slot of a pending AolkmeEvent_Request.
+ *
+ * state holds (generation << 8) | state, so that a stale reply handle fails its compare-and-swap.
+ */
+typedef struct
+{
+    volatile uint32_t               state;                      ///< Generation and AOLKME_EVENT_REPLY_* state
+    T_AolkmeSemaHandle              sem;                        ///< Posted once the reply is written, created at init
+    void*                           buffer;                     ///< Requester's response buffer
+    size_t                          capacity;                   ///< Bytes available in buffer
+    size_t                          size;                       ///< Size of the reply
+} T_AolkmeEventReplySlot;
+
+
+/**
+ * @brief Full-queue policy of one event ID.
+ *
+ * Publishers scan the rules without the mutex, like coalesce_ids[]: a publish racing
+ * AolkmeEvent_SetBackpressure may still apply the previous policy.
+ */
+typedef struct
+{
+    volatile uint32_t               id;                         ///< Event ID
+    volatile uint32_t               policy;                     ///< E_AolkmeEventBackpressure
+    volatile uint32_t               timeout_ms;                 ///< Wait of AOLKME_EVENT_BACKPRESSURE_BLOCK
+} T_AolkmeEventBackpressureRule;
+
+
+/**
+ * @brief Last dispatched event of one sticky ID. Guarded by the mutex.
+ */
+typedef struct
+{
+    bool                            valid;                      ///< An event was cached
+    T_AolkmeEvent                   event;                      ///< Cached event, payload shared or not owned
+} T_AolkmeEventStickySlot;
+
+/**
+ * @brief Cached events still to be handed to a new subscriber.
+ */
+typedef struct
+{
+    E_AolkmeEventID                 first;                      ///< Subscribed range, or value of a mask route
+    E_AolkmeEventID                 last;
+    E_AolkmeEventID                 mask;                       ///< Mask route, 0 for a range
+    AolkmeEventRefHandler           handler;                    ///< New subscriber, by reference
+    AolkmeEventHandler              value_handler;              ///< New subscriber, by value
+    volatile uint8_t                workers;                    ///< Bit per worker that still has to deliver, 0: entry free
+} T_AolkmeEventStickyDelivery;
+
+
+/**
+ * @brief Slot of the trace ring.
+ */
+typedef struct
+{
+    volatile uint32_t               sequence;                   ///< Ring position + 1 once written, 0 while being written
+    T_AolkmeEventTraceRecord        record;
+} T_AolkmeEventTraceSlot;
+
+
+// event system context
+typedef struct
+{
+    T_AolkmeMutexHandle             mutex;                     ///< Mutex for synchronizing access to the event system
+
+    // queue
+    uint8_t                         queue_mode;                 ///< E_AolkmeEventQueueMode
+    uint8_t                         lane_count;                 ///< Number of priority lanes per worker
+    bool                            weighted;                   ///< Weighted instead of strict-priority dequeue
+    T_AolkmeEventWorker*            workers;                    ///< Event tasks and their queue partitions
+    uint8_t                         worker_count;               ///< Number of workers
+    uint32_t                        queue_capacity;             ///< Sum of the lane capacities of all workers
+
+    // coalescing
+    volatile uint32_t               coalesce_ids[MAX_EVENT_SYSTEM_COALESCE_IDS];    ///< IDs published last-value-wins
+    volatile uint32_t               coalesce_id_count;          ///< Entries in coalesce_ids[]
+    T_AolkmeEventCoalesceSlot       coalesce_slots[MAX_EVENT_SYSTEM_COALESCE_SLOTS]; ///< Pending coalesced events
+
+    // backpressure
+    T_AolkmeEventBackpressureRule   backpressure_rules[MAX_EVENT_SYSTEM_BACKPRESSURE_IDS]; ///< Full-queue policy per ID
+    volatile uint32_t               backpressure_rule_count;    ///< Entries in backpressure_rules[]
+
+    // payload pool
+    T_AolkmeEventPool*              pools;                      ///< Size classes, ascending block_size
+    uint8_t                         pool_count;                 ///< Number of size classes
+
+    // routing table (copy-on-write)
+    T_AolkmeEventRouteTable* volatile route_table;              ///< Current snapshot, swapped atomically
+    T_AolkmeEventRouteTable* volatile route_retired;            ///< Replaced snapshots waiting to be freed
+    volatile uint32_t               route_epoch;                ///< Incremented on every snapshot swap
+    volatile uint32_t               route_reclaim_epoch;        ///< Lowest retire_epoch in route_retired
+    uint16_t                        handler_capacity;           ///< Maximum number of routes
+
+    // static routes (config static_routes, never change after init)
+    const T_AolkmeEventStaticRoute* static_routes;              ///< Sorted by first, NULL if none
+    uint16_t                        static_route_count;         ///< Entries in static_routes
+    uint32_t                        static_max_span;            ///< Largest last - first, bounds the search window
+
+    // statistics
+    T_AolkmeEventCounters           counters;                   ///< Publish, drop, depth and latency counters
+    T_AolkmeEventHandlerStatsSlot*  handler_stats;              ///< One entry per handler ever subscribed
+    volatile uint32_t               handler_stats_count;        ///< Entries used in handler_stats[]
+    uint16_t                        handler_stats_capacity;     ///< Entries allocated in handler_stats[]
+
+    // trace ring
+    T_AolkmeEventTraceSlot*         trace_ring;                 ///< Dispatched events, NULL if not configured
+    uint32_t                        trace_mask;                 ///< Slots - 1 (power of two)
+    volatile uint32_t               trace_head;                 ///< Next position to write
+    volatile uint32_t               trace_tail;                 ///< First position not yet dumped or cleared
+    volatile bool                   trace_enabled;              ///< Recording
+
+    // sticky events
+    volatile uint32_t               sticky_ids[MAX_EVENT_SYSTEM_STICKY_IDS];      ///< IDs whose last event is kept
+    volatile uint32_t               sticky_id_count;            ///< Entries in sticky_ids[]
+    T_AolkmeEventStickySlot         sticky_slots[MAX_EVENT_SYSTEM_STICKY_IDS];    ///< Cached events, parallel to sticky_ids[]
+    T_AolkmeEventStickyDelivery     sticky_deliveries[MAX_EVENT_SYSTEM_STICKY_IDS]; ///< Pending deliveries to new subscribers
+    volatile uint32_t               sticky_delivery_count;      ///< Entries in use in sticky_deliveries[]
+
+    // request/response
+    T_AolkmeEventReplySlot          replies[MAX_EVENT_SYSTEM_REPLY_SLOTS]; ///< Reply slots of pending requests
+
+    // timers (run by the first worker)
+    T_AolkmeEventTimer              timers[MAX_EVENT_SYSTEM_TIMERS];     ///< Timer slots, indexed by handle
+    uint8_t                         timer_heap[MAX_EVENT_SYSTEM_TIMERS]; ///< Slot indices, min-heap on due_ms
+    uint8_t                         timer_count;                ///< Entries in timer_heap[]
+
+
+    bool                            initialized;                  ///< Flag indicating if the event system is initialized
+    bool                            task_running;                 ///< Flag indicating if the event processing tasks are running
+
+} T_AolkmeEventSystemContext;
+
+
+// event system context
+extern T_AolkmeEventSystemContext g_event_system_context;
+
+
+
+// ================= Aolkme_event.c ================= //
+
+T_AolkmeReturnCode AolkmeEvent_Lock(void);
+
+T_AolkmeReturnCode AolkmeEvent_Unlock(void);
+
+/**
+ * @brief Release the payload of an event that will not be dispatched (any more).
+ */
+void AolkmeEvent_FreeData(T_AolkmeEvent* event);
+
+
+// ================= Aolkme_event_queue.c ================= //
+
+/**
+ * @brief Allocate the workers and their lanes. Each lane holds its size - 1 events in either mode.
+ */
+T_AolkmeReturnCode AolkmeEvent_QueueInit(const T_AolkmeEventSystemConfig* config);
+
+/**
+ * @brief Free the event queue. Pending events must have been drained.
+ */
+void AolkmeEvent_QueueDeinit(void);
+
+/**
+ * @brief Worker that dispatches event: chosen by a hash of event->ID.
+ */
+T_AolkmeEventWorker* AolkmeEvent_QueueWorkerOf(const T_AolkmeEvent* event);
+
+/**
+ * @brief Append a copy of event to the worker's lane of its priority. Safe from any number of tasks.
+ */
+T_AolkmeReturnCode AolkmeEvent_QueuePush(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event);
+
+/**
+ * @brief Make room in the full lane of event: remove the oldest queued event of the lane
+ * (DROP_OLDEST) or its lowest-priority one below event's priority (DROP_LOWEST), free its
+ * payload and count it. Lock-free mode only considers the oldest event.
+ *
+ * @return false if no event could be evicted
+ */
+bool AolkmeEvent_QueueEvict(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event, uint8_t policy);
+
+/**
+ * @brief Append a copy of event to the worker's interrupt ring. Never blocks, safe from any ISR.
+ */
+T_AolkmeReturnCode AolkmeEvent_QueuePushFromISR(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event);
+
+/**
+ * @brief Remove the worker's next event: interrupt events first, then by lane priority (strict
+ * or weighted). Single consumer per worker (its task, or Deinit once it stopped).
+ */
+bool AolkmeEvent_QueuePop(T_AolkmeEventWorker* worker, T_AolkmeEvent* event);
+
+/**
+ * @brief Remove up to max events in QueuePop order, taking the mutex at most once.
+ *
+ * @return Number of events stored in events[]
+ */
+uint16_t AolkmeEvent_QueuePopBatch(T_AolkmeEventWorker* worker, T_AolkmeEvent* events, uint16_t max);
+
+/**
+ * @brief Number of queued events (a snapshot in lock-free mode).
+ */
+uint32_t AolkmeEvent_QueueCount(void);
+
+/**
+ * @brief Fill the status of one lane, summed over all workers.
+ */
+T_AolkmeReturnCode AolkmeEvent_QueueLaneStatus(uint8_t lane, T_AolkmeEventLaneStatus* status);
+
+
+// ================= Aolkme_event_backpressure.c ================= //
+
+/**
+ * @brief Policy of id, AOLKME_EVENT_BACKPRESSURE_REJECT if it has no rule. Lock-free.
+ */
+uint8_t AolkmeEvent_BackpressureRule(E_AolkmeEventID id, uint32_t* timeout_ms);
+
+/**
+ * @brief Push event, applying policy if its lane is full. A dropped event's payload is freed
+ * and event->data cleared, except with AOLKME_EVENT_BACKPRESSURE_REJECT.
+ */
+T_AolkmeReturnCode AolkmeEvent_BackpressurePush(T_AolkmeEventWorker* worker, T_AolkmeEvent* event, uint8_t policy, uint32_t timeout_ms);
+
+/**
+ * @brief count events left the worker's queue: wake publishers blocked on it.
+ */
+void AolkmeEvent_BackpressureWake(T_AolkmeEventWorker* worker, uint16_t count);
+
+
+// ================= Aolkme_event_pool.c ================= //
+
+/**
+ * @brief Carve the payload pool size classes out of one allocation.
+ */
+T_AolkmeReturnCode AolkmeEvent_PoolInit(const T_AolkmeEventPoolConfig* pools, uint8_t pool_count);
+
+/**
+ * @brief Free the payload pool. All blocks must have been returned.
+ */
+void AolkmeEvent_PoolDeinit(void);
+
+/**
+ * @brief Return data to the pool if it is a pool block.
+ *
+ * @return true if data belonged to the pool
+ */
+bool AolkmeEvent_PoolRelease(void* data);
+
+
+// ================= Aolkme_event_stats.c ================= //
+
+/**
+ * @brief Reset the counters and allocate the handler stats table.
+ */
+T_AolkmeReturnCode AolkmeEvent_StatsInit(uint16_t handler_capacity);
+
+/**
+ * @brief Free the handler stats table.
+ */
+void AolkmeEvent_StatsDeinit(void);
+
+/**
+ * @brief Stats entry of a handler, allocated on first use. Caller holds the mutex.
+ *
+ * @return Entry index, AOLKME_EVENT_STATS_NONE if the table is full
+ */
+uint16_t AolkmeEvent_StatsHandlerSlot(AolkmeEventRefHandler handler, AolkmeEventHandler value_handler);
+
+/**
+ * @brief Account one handler call of time_us.
+ */
+void AolkmeEvent_StatsHandlerTime(uint16_t slot, uint32_t time_us);
+
+/**
+ * @brief An event took a queue slot / count events left the queue (tracks depth and peak depth).
+ */
+void AolkmeEvent_StatsEnqueued(void);
+void AolkmeEvent_StatsDequeued(uint32_t count);
+
+/**
+ * @brief Account one dispatched event and its publish-to-dispatch latency.
+ */
+void AolkmeEvent_StatsDispatched(uint32_t latency_us);
+
+/**
+ * @brief Current time for handler timing: GetTimeUs if available, else GetTimeMs * 1000.
+ */
+uint32_t AolkmeEvent_StatsTimeUs(void);
+
+
+// ================= Aolkme_event_trace.c ================= //
+
+/**
+ * @brief Allocate the trace ring, nothing if size is 0.
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceInit(uint16_t size);
+
+/**
+ * @brief Free the trace ring.
+ */
+void AolkmeEvent_TraceDeinit(void);
+
+/**
+ * @brief Append a dispatched event. Safe from several workers at once, never blocks.
+ */
+void AolkmeEvent_TraceRecord(const T_AolkmeEvent* event, uint32_t dispatch_us);
+
+
+// ================= Aolkme_event_sticky.c ================= //
+
+/**
+ * @brief Clear the sticky IDs and deliveries.
+ */
+void AolkmeEvent_StickyInit(void);
+
+/**
+ * @brief Drop all cached events. The event tasks must be stopped.
+ */
+void AolkmeEvent_StickyDeinit(void);
+
+/**
+ * @brief Cache a dispatched event of a sticky ID, taking over its payload.
+ *
+ * @return false if event->ID is not sticky: the caller still owns the payload
+ */
+bool AolkmeEvent_StickyStore(T_AolkmeEvent* event);
+
+/**
+ * @brief Queue delivery of the cached events in route's range to its handler. Mutex held.
+ */
+void AolkmeEvent_StickySubscribed(const T_AolkmeEventRoute* route);
+
+/**
+ * @brief Deliver the pending cached events of IDs dispatched by worker.
+ */
+void AolkmeEvent_StickyDeliver(T_AolkmeEventWorker* worker);
+
+
+// ================= Aolkme_event_reply.c ================= //
+
+/**
+ * @brief Create the reply slot semaphores.
+ */
+T_AolkmeReturnCode AolkmeEvent_ReplyInit(void);
+
+/**
+ * @brief Destroy the reply slot semaphores. No request may be pending.
+ */
+void AolkmeEvent_ReplyDeinit(void);
+
+
+// ================= Aolkme_event_timer.c ================= //
+
+/**
+ * @brief Clear all timer slots.
+ */
+void AolkmeEvent_TimerInit(void);
+
+/**
+ * @brief Drop all armed timers and release their payloads. The event tasks must be stopped.
+ */
+void AolkmeEvent_TimerDeinit(void);
+
+/**
+ * @brief Publish every timer that is due.
+ *
+ * @return Milliseconds until the next timer is due, at most max_wait_ms
+ */
+uint32_t AolkmeEvent_TimerRun(uint32_t max_wait_ms);
+
+
+// ================= Aolkme_event_route.c ================= //
+
+/**
+ * @brief Allocate the initial (empty) routing table and install the static routes.
+ */
+T_AolkmeReturnCode AolkmeEvent_RouteInit(uint16_t capacity, const T_AolkmeEventStaticRoute* static_routes, uint16_t static_count);
+
+/**
+ * @brief Free the current and all retired routing tables. The event task must be stopped.
+ */
+void AolkmeEvent_RouteDeinit(void);
+
+/**
+ * @brief Pin the current routing table for dispatch. Must be paired with AolkmeEvent_RouteRelease().
+ */
+const T_AolkmeEventRouteTable* AolkmeEvent_RouteAcquire(T_AolkmeEventWorker* worker);
+
+/**
+ * @brief Unpin the routing table; retired tables are freed once no dispatch can still see them.
+ */
+void AolkmeEvent_RouteRelease(T_AolkmeEventWorker* worker);
+
+/**
+ * @brief Call every handler of the table routed to event->ID.
+ */
+void AolkmeEvent_RouteDispatch(const T_AolkmeEventRouteTable* table, const T_AolkmeEvent* event);
+
+/**
+ * @brief Whether a subscription (range, or mask route when mask is not 0) covers id.
+ */
+static __inline bool AolkmeEvent_RouteMatches(E_AolkmeEventID first, E_AolkmeEventID last, E_AolkmeEventID mask, E_AolkmeEventID id)
+{
+    return (mask != 0) ? ((id & mask) == first) : (id >= first && id <= last);
+}
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // AOLKME_EVENT_PRIVATE_H
@@ -27,11 +27,19 @@ extern "C" {
 
 
 
+/**
+ * @brief Largest log record in the ring, header included
+ */
+#define LOGGER_BUFFER_RECORD_MAX 256
+
+
+/**
+ * @brief Log record in the ring, length-prefixed and padded to a word.
+ */
 typedef struct {
-    E_AolkmeLoggerConsoleLogLevel level;
-    uint16_t length;
+    volatile uint32_t header;       // !< COMMITTED / PAD flags | level << 16 | length, 0 until committed
     uint8_t data[];
-} T_AolkmeLoggerBlock;
+} T_AolkmeLoggerRecord;
 
 
 
@@ -47,11 +55,11 @@ typedef struct {
 
 
 /**
- * @brief Initialize the logger buffer.
- * @param size The size of the buffer.
+ * @brief Initialize the logger buffer: allocate the record ring and start the flush task.
+ * @param config buffer_size, overflow and overflow_wait_ms are used.
  * @return T_AolkmeReturnCode
  */
-T_AolkmeReturnCode AolkmeLogger_BufferInit(size_t size);
+T_AolkmeReturnCode AolkmeLogger_BufferInit(const T_AolkmeLoggerConfig *config);
 
 /**
  * @brief Deinitialize the logger buffer.
@@ -77,6 +85,11 @@ T_AolkmeReturnCode AolkmeLogger_BufferPut(E_AolkmeLoggerConsoleLogLevel level, u
  */
 T_AolkmeReturnCode AolkmeLogger_BufferFlush(void);
 
+/**
+ * @brief Fill the ring usage fields of stats.
+ */
+void AolkmeLogger_BufferStats(T_AolkmeLoggerStats *stats);
+
 
 
 
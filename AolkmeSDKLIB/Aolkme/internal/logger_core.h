@@ -57,8 +57,10 @@ typedef struct{
     uint8_t output_count;                               // !< Current backend count
 
     // Performance counters
-    uint32_t log_count;                                  // !< Log count
-    uint32_t unlog_count;                                // !< Unlogged/dropped log count
+    volatile uint32_t log_count;                         // !< Log count
+    volatile uint32_t unlog_count;                       // !< Unlogged/dropped log count
+    volatile uint32_t drop_buffer_full;                  // !< Dropped, record ring full
+    volatile uint32_t truncated_count;                   // !< Logs cut to the record size
 
 } T_AolkmeLoggerState;
 
@@ -0,0 +1,331 @@
+/**
+ * @file Aolkme_event_pool.c
+ * @author Aolkme
+ * @brief 事件数据内存池：按大小分级的固定块，O(1) 无锁分配/释放，可在中断中使用；引用计数共享数据
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+#define EVENT_POOL_ALIGN                8u
+#define EVENT_POOL_INDEX_NONE           0xFFFFu
+#define EVENT_POOL_INDEX(head)          ((head) & 0xFFFFu)
+#define EVENT_POOL_HEAD(tag, index)     (((uint32_t)(tag) << 16) | (index))
+
+// Shared payloads carry their reference count in front of the data, keeping it 8-byte aligned
+#define EVENT_SHARED_HEADER_SIZE        EVENT_POOL_ALIGN
+#define EVENT_SHARED_REFS(data)         ((volatile uint32_t*)((uint8_t*)(data) - EVENT_SHARED_HEADER_SIZE))
+
+
+
+static void* event_pool_pop(T_AolkmeEventPool* pool);
+static void event_pool_push(T_AolkmeEventPool* pool, uint16_t index);
+static T_AolkmeEventPool* event_pool_owner(const void* data);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+void* AolkmeEvent_PoolAlloc(size_t size)
+{
+    if (!g_event_system_context.initialized || g_event_system_context.pool_count == 0) {
+        return NULL;
+    }
+
+    T_AolkmeEventPool* fitting = NULL;
+
+    // Smallest class that fits first, then the larger ones
+    for (uint8_t i = 0; i < g_event_system_context.pool_count; i++) {
+        T_AolkmeEventPool* pool = &g_event_system_context.pools[i];
+        if (pool->block_size < size) {
+            continue;
+        }
+        if (fitting == NULL) {
+            fitting = pool;
+        }
+
+        void* block = event_pool_pop(pool);
+        if (block != NULL) {
+            return block;
+        }
+    }
+
+    // Oversized requests are counted against the largest class
+    if (fitting == NULL) {
+        fitting = &g_event_system_context.pools[g_event_system_context.pool_count - 1];
+    }
+    AolkmeAtomic_Add32(&fitting->alloc_failures, 1);
+
+    return NULL;
+}
+
+
+T_AolkmeReturnCode AolkmeEvent_PoolFree(void* data)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (!AolkmeEvent_PoolRelease(data)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+T_AolkmeReturnCode AolkmeEvent_GetPoolStatus(uint8_t pool_index, T_AolkmeEventPoolStatus* status)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (pool_index >= g_event_system_context.pool_count || status == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeEventPool* pool = &g_event_system_context.pools[pool_index];
+    status->block_size = pool->block_size;
+    status->block_count = pool->block_count;
+    status->in_use = (uint16_t)AolkmeAtomic_Load32(&pool->in_use);
+    status->high_water = (uint16_t)AolkmeAtomic_Load32(&pool->high_water);
+    status->alloc_failures = AolkmeAtomic_Load32(&pool->alloc_failures);
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void* AolkmeEvent_SharedAlloc(size_t size)
+{
+    uint8_t* block = (uint8_t*)AolkmeEvent_PoolAlloc(size + EVENT_SHARED_HEADER_SIZE);
+
+    if (block == NULL) {
+        T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+        if (!osal) {
+            return NULL;
+        }
+        block = (uint8_t*)osal->Malloc(size + EVENT_SHARED_HEADER_SIZE);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    void* data = block + EVENT_SHARED_HEADER_SIZE;
+    AolkmeAtomic_Store32(EVENT_SHARED_REFS(data), 1);
+    return data;
+}
+
+
+void AolkmeEvent_SharedRetain(void* data)
+{
+    if (data != NULL) {
+        AolkmeAtomic_Add32(EVENT_SHARED_REFS(data), 1);
+    }
+}
+
+
+void AolkmeEvent_SharedRelease(void* data)
+{
+    if (data == NULL || AolkmeAtomic_Add32(EVENT_SHARED_REFS(data), (uint32_t)-1) != 0) {
+        return;
+    }
+
+    // Last reference
+    void* block = (uint8_t*)data - EVENT_SHARED_HEADER_SIZE;
+    if (AolkmeEvent_PoolRelease(block)) {
+        return;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (osal) {
+        osal->Free(block);
+    }
+}
+
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+T_AolkmeReturnCode AolkmeEvent_PoolInit(const T_AolkmeEventPoolConfig* pools, uint8_t pool_count)
+{
+    g_event_system_context.pools = NULL;
+    g_event_system_context.pool_count = 0;
+
+    if (pool_count == 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    }
+
+    if (pools == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    // Class headers followed by every class's blocks, in one allocation
+    uint32_t header_size = (pool_count * sizeof(T_AolkmeEventPool) + EVENT_POOL_ALIGN - 1) & ~(EVENT_POOL_ALIGN - 1);
+    uint32_t total_size = header_size;
+    for (uint8_t i = 0; i < pool_count; i++) {
+        uint32_t block_size = (pools[i].block_size + EVENT_POOL_ALIGN - 1) & ~(EVENT_POOL_ALIGN - 1);
+        if (block_size == 0 || block_size > 0xFFF8u ||
+            pools[i].block_count == 0 || pools[i].block_count >= EVENT_POOL_INDEX_NONE ||
+            (i > 0 && pools[i].block_size < pools[i - 1].block_size)) {
+            return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+        }
+        total_size += block_size * pools[i].block_count;
+    }
+
+    uint8_t* memory = (uint8_t*)osal->Malloc(total_size);
+    if (memory == NULL) {
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+    memset(memory, 0, header_size);
+
+    T_AolkmeEventPool* classes = (T_AolkmeEventPool*)memory;
+    uint8_t* blocks = memory + header_size;
+
+    for (uint8_t i = 0; i < pool_count; i++) {
+        T_AolkmeEventPool* pool = &classes[i];
+        pool->base = blocks;
+        pool->block_size = (uint16_t)((pools[i].block_size + EVENT_POOL_ALIGN - 1) & ~(EVENT_POOL_ALIGN - 1));
+        pool->block_count = pools[i].block_count;
+
+        // Chain every block: block n links to n + 1, the last one ends the stack
+        for (uint16_t n = 0; n < pool->block_count; n++) {
+            uint16_t next = (n + 1 < pool->block_count) ? (uint16_t)(n + 1) : (uint16_t)EVENT_POOL_INDEX_NONE;
+            memcpy(pool->base + (uint32_t)n * pool->block_size, &next, sizeof(next));
+        }
+        pool->free_head = EVENT_POOL_HEAD(0, 0);
+
+        blocks += (uint32_t)pool->block_size * pool->block_count;
+    }
+
+    AOLKME_ATOMIC_FENCE();
+    g_event_system_context.pools = classes;
+    g_event_system_context.pool_count = pool_count;
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void AolkmeEvent_PoolDeinit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return;
+    }
+
+    if (g_event_system_context.pools != NULL) {
+        osal->Free(g_event_system_context.pools);
+    }
+    g_event_system_context.pools = NULL;
+    g_event_system_context.pool_count = 0;
+}
+
+
+bool AolkmeEvent_PoolRelease(void* data)
+{
+    T_AolkmeEventPool* pool = event_pool_owner(data);
+    if (pool == NULL) {
+        return false;
+    }
+
+    uint32_t offset = (uint32_t)((uint8_t*)data - pool->base);
+    event_pool_push(pool, (uint16_t)(offset / pool->block_size));
+    return true;
+}
+
+
+
+
+
+
+
+
+// ================= Free Stack ================= //
+
+/**
+ * @brief Pop the top free block.
+ *
+ * The tag changes on every pop and push, so a CAS cannot succeed on a head that was popped
+ * and pushed back in between (ABA) unless exactly 65536 operations interleaved.
+ */
+static void* event_pool_pop(T_AolkmeEventPool* pool)
+{
+    uint32_t head;
+    uint16_t index;
+    uint16_t next;
+
+    do {
+        head = AolkmeAtomic_Load32(&pool->free_head);
+        index = (uint16_t)EVENT_POOL_INDEX(head);
+        if (index == EVENT_POOL_INDEX_NONE) {
+            return NULL;
+        }
+        memcpy(&next, pool->base + (uint32_t)index * pool->block_size, sizeof(next));
+    } while (!AolkmeAtomic_CompareExchange32(&pool->free_head, head, EVENT_POOL_HEAD((head >> 16) + 1, next)));
+
+    // High-water mark
+    AolkmeAtomic_Add32(&pool->in_use, 1);
+    uint32_t in_use = AolkmeAtomic_Load32(&pool->in_use);
+    uint32_t high_water = AolkmeAtomic_Load32(&pool->high_water);
+    while (in_use > high_water &&
+           !AolkmeAtomic_CompareExchange32(&pool->high_water, high_water, in_use)) {
+        high_water = AolkmeAtomic_Load32(&pool->high_water);
+    }
+
+    return pool->base + (uint32_t)index * pool->block_size;
+}
+
+
+static void event_pool_push(T_AolkmeEventPool* pool, uint16_t index)
+{
+    uint8_t* block = pool->base + (uint32_t)index * pool->block_size;
+    uint32_t head;
+
+    // Count the block as free before it can be popped again, so in_use never exceeds block_count
+    AolkmeAtomic_Add32(&pool->in_use, (uint32_t)-1);
+
+    do {
+        head = AolkmeAtomic_Load32(&pool->free_head);
+        uint16_t next = (uint16_t)EVENT_POOL_INDEX(head);
+        memcpy(block, &next, sizeof(next));
+    } while (!AolkmeAtomic_CompareExchange32(&pool->free_head, head, EVENT_POOL_HEAD((head >> 16) + 1, index)));
+}
+
+
+/**
+ * @brief Size class whose block range contains data, NULL if data is not a pool block.
+ */
+static T_AolkmeEventPool* event_pool_owner(const void* data)
+{
+    const uint8_t* ptr = (const uint8_t*)data;
+
+    for (uint8_t i = 0; i < g_event_system_context.pool_count; i++) {
+        T_AolkmeEventPool* pool = &g_event_system_context.pools[i];
+        const uint8_t* end = pool->base + (uint32_t)pool->block_size * pool->block_count;
+        if (ptr >= pool->base && ptr < end) {
+            return pool;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,327 @@
+/**
+ * @file Aolkme_event_trace.c
+ * @author Aolkme
+ * @brief 事件轨迹：记录每个已分发事件（ID、时间戳、来源、数据大小、处理耗时），可导出并在主机上回放
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+#define EVENT_TRACE_CHUNK_RECORDS       16      // Records per AolkmeEventTraceWriter call
+#define EVENT_TRACE_SETTLE_TRIES        10      // 1 ms waits for a record still being written
+
+
+
+static bool event_trace_read(uint32_t position, T_AolkmeEventTraceRecord* record);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Start or stop recording dispatched events.
+ *
+ * @param enable
+ * @return T_AolkmeReturnCode NOT_SUPPORTED if no trace ring was configured
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceEnable(bool enable)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (g_event_system_context.trace_ring == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_NOT_SUPPORTED;
+    }
+
+    g_event_system_context.trace_enabled = enable;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Forget all recorded events.
+ *
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceClear(void)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (g_event_system_context.trace_ring == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_NOT_SUPPORTED;
+    }
+
+    AolkmeAtomic_Store32(&g_event_system_context.trace_tail, AolkmeAtomic_Load32(&g_event_system_context.trace_head));
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Write the records not dumped yet, oldest first, then drop them from the ring.
+ *
+ * Recording is paused while dumping so that the record count in the header stays exact;
+ * events dispatched meanwhile are not recorded.
+ *
+ * @param write
+ * @return T_AolkmeReturnCode Error of write, which aborts the dump
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceDump(AolkmeEventTraceWriter write)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (write == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    if (g_event_system_context.trace_ring == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_NOT_SUPPORTED;
+    }
+
+    bool was_enabled = g_event_system_context.trace_enabled;
+    g_event_system_context.trace_enabled = false;
+
+    uint32_t head = AolkmeAtomic_Load32(&g_event_system_context.trace_head);
+    uint32_t tail = AolkmeAtomic_Load32(&g_event_system_context.trace_tail);
+    uint32_t first = tail;
+
+    // Older records have been overwritten
+    if (head - tail > g_event_system_context.trace_mask + 1) {
+        first = head - (g_event_system_context.trace_mask + 1);
+    }
+
+    T_AolkmeEventTraceHeader header = {
+        .magic = AOLKME_EVENT_TRACE_MAGIC,
+        .version = AOLKME_EVENT_TRACE_VERSION,
+        .record_size = sizeof(T_AolkmeEventTraceRecord),
+        .record_count = head - first,
+        .lost_count = first - tail,
+    };
+
+    T_AolkmeReturnCode returncode = write((const uint8_t*)&header, sizeof(header));
+
+    T_AolkmeEventTraceRecord chunk[EVENT_TRACE_CHUNK_RECORDS];
+    uint16_t count = 0;
+
+    for (uint32_t position = first; position != head && returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS; position++) {
+        event_trace_read(position, &chunk[count++]);
+
+        if (count == EVENT_TRACE_CHUNK_RECORDS || position + 1 == head) {
+            returncode = write((const uint8_t*)chunk, (uint16_t)(count * sizeof(T_AolkmeEventTraceRecord)));
+            count = 0;
+        }
+    }
+
+    if (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeAtomic_Store32(&g_event_system_context.trace_tail, head);
+    }
+
+    g_event_system_context.trace_enabled = was_enabled;
+    return returncode;
+}
+
+
+/**
+ * @brief Publish the events of a trace dump again, keeping their relative timing.
+ *
+ * @param dump
+ * @param size
+ * @param speed 1: original timing, n: n times faster, 0: no delays
+ * @return T_AolkmeReturnCode INVALID_PARAMETER if dump is not a complete trace dump
+ */
+T_AolkmeReturnCode AolkmeEvent_TraceReplay(const void* dump, uint32_t size, uint16_t speed)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    T_AolkmeEventTraceHeader header;
+    if (dump == NULL || size < sizeof(header)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    // The dump may come from a file or a UART buffer at any alignment
+    const uint8_t* bytes = (const uint8_t*)dump;
+    memcpy(&header, bytes, sizeof(header));
+
+    if (header.magic != AOLKME_EVENT_TRACE_MAGIC || header.version != AOLKME_EVENT_TRACE_VERSION ||
+        header.record_size != sizeof(T_AolkmeEventTraceRecord) ||
+        (size - sizeof(header)) / sizeof(T_AolkmeEventTraceRecord) < header.record_count) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    uint32_t start_ms;
+    uint32_t first_timestamp = 0;
+    osal->GetTimeMs(&start_ms);
+
+    for (uint32_t i = 0; i < header.record_count; i++) {
+        T_AolkmeEventTraceRecord record;
+        memcpy(&record, bytes + sizeof(header) + i * sizeof(record), sizeof(record));
+
+        if (i == 0) {
+            first_timestamp = record.timestamp;
+        }
+
+        // Sleep until the recorded offset, scaled; measured from the start so delays do not add up
+        if (speed != 0) {
+            uint32_t now;
+            osal->GetTimeMs(&now);
+            int32_t wait = (int32_t)((record.timestamp - first_timestamp) / speed - (now - start_ms));
+            if (wait > 0) {
+                osal->TaskSleepMs((uint32_t)wait);
+            }
+        }
+
+        T_AolkmeEvent event = {
+            .ID = record.ID,
+            .source = (void*)(uintptr_t)record.source,
+            .data_size = record.data_size,
+            .name = "TraceReplay",
+        };
+
+        // Handlers may read data_size bytes, give them zeros instead of the unrecorded payload
+        if (record.data_size > 0) {
+            event.data = AolkmeEvent_SharedAlloc(record.data_size);
+            if (event.data == NULL) {
+                return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+            }
+            memset(event.data, 0, record.data_size);
+            event.flags = EVENT_FLAG_SHARED_DATA;
+        }
+
+        // Unpaced replay measures throughput: wait for the queue instead of dropping
+        T_AolkmeReturnCode returncode;
+        if (speed == 0) {
+            returncode = AolkmeEvent_PublishEventPolicy(&event, AOLKME_EVENT_BACKPRESSURE_BLOCK, AOLKME_EVENT_WAIT_FOREVER);
+        } else {
+            returncode = AolkmeEvent_PublishEvent(&event);
+        }
+
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS && event.data != NULL) {
+            AolkmeEvent_SharedRelease(event.data);
+        }
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+T_AolkmeReturnCode AolkmeEvent_TraceInit(uint16_t size)
+{
+    g_event_system_context.trace_ring = NULL;
+    g_event_system_context.trace_mask = 0;
+    g_event_system_context.trace_head = 0;
+    g_event_system_context.trace_tail = 0;
+    g_event_system_context.trace_enabled = false;
+
+    if (size == 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    // Power of two, so that position & mask stays consistent across the 32-bit wrap
+    uint32_t slot_count = 1;
+    while (slot_count < size) {
+        slot_count <<= 1;
+    }
+
+    g_event_system_context.trace_ring = (T_AolkmeEventTraceSlot*)osal->Malloc(slot_count * sizeof(T_AolkmeEventTraceSlot));
+    if (g_event_system_context.trace_ring == NULL) {
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+    memset(g_event_system_context.trace_ring, 0, slot_count * sizeof(T_AolkmeEventTraceSlot));
+
+    g_event_system_context.trace_mask = slot_count - 1;
+    g_event_system_context.trace_enabled = true;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void AolkmeEvent_TraceDeinit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+
+    g_event_system_context.trace_enabled = false;
+    if (osal && g_event_system_context.trace_ring != NULL) {
+        osal->Free(g_event_system_context.trace_ring);
+    }
+    g_event_system_context.trace_ring = NULL;
+}
+
+
+void AolkmeEvent_TraceRecord(const T_AolkmeEvent* event, uint32_t dispatch_us)
+{
+    // Claim a position, then publish the slot through its sequence once it is complete
+    uint32_t position = AolkmeAtomic_Add32(&g_event_system_context.trace_head, 1) - 1;
+    T_AolkmeEventTraceSlot* slot = &g_event_system_context.trace_ring[position & g_event_system_context.trace_mask];
+
+    AolkmeAtomic_Store32(&slot->sequence, 0);
+    slot->record.ID = event->ID;
+    slot->record.timestamp = event->timestamp;
+    slot->record.source = (uint32_t)(uintptr_t)event->source;
+    slot->record.data_size = (uint32_t)event->data_size;
+    slot->record.dispatch_us = dispatch_us;
+    AolkmeAtomic_Store32(&slot->sequence, position + 1);
+}
+
+
+
+
+
+
+
+// ================= Helpers ================= //
+
+/**
+ * @brief Copy the record at position. A worker that claimed it before recording was paused
+ * may still be writing it; give it a few ms, then return a zeroed record.
+ */
+static bool event_trace_read(uint32_t position, T_AolkmeEventTraceRecord* record)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    const T_AolkmeEventTraceSlot* slot = &g_event_system_context.trace_ring[position & g_event_system_context.trace_mask];
+
+    for (uint8_t tries = 0; tries <= EVENT_TRACE_SETTLE_TRIES; tries++) {
+        if (AolkmeAtomic_Load32(&slot->sequence) == position + 1) {
+            *record = slot->record;
+            return true;
+        }
+        if (osal) {
+            osal->TaskSleepMs(1);
+        }
+    }
+
+    memset(record, 0, sizeof(*record));
+    return false;
+}
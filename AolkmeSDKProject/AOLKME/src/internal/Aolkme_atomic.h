@@ -0,0 +1,128 @@
+/**
+ * @file Aolkme_atomic.h
+ * @brief Minimal atomic helpers for the SDK internals.
+ *
+ * ARMCC 5 (Keil, C99) has no <stdatomic.h>, so it uses the DMB and LDREX/STREX intrinsics;
+ * GCC/Clang based toolchains (ARMCC 6, ESP-IDF, host builds) use the __atomic builtins, which
+ * ESP-IDF lowers to S32C1I on Xtensa cores.
+ * Aligned 32-bit and pointer accesses are single-copy atomic on every supported core.
+ *
+ * 注意：此头文件仅供SDK内部使用
+ */
+
+
+
+
+#ifndef AOLKME_ATOMIC_H
+#define AOLKME_ATOMIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#if defined(__ARMCC_VERSION) && (__ARMCC_VERSION < 6000000)
+
+#define AOLKME_ATOMIC_FENCE()                   __dmb(0xF)
+
+static __inline uint32_t AolkmeAtomic_Load32(const volatile uint32_t *ptr)
+{
+    uint32_t value = *ptr;
+    __dmb(0xF);
+    return value;
+}
+
+static __inline void AolkmeAtomic_Store32(volatile uint32_t *ptr, uint32_t value)
+{
+    __dmb(0xF);
+    *ptr = value;
+    __dmb(0xF);
+}
+
+static __inline void *AolkmeAtomic_LoadPtr(void * volatile *ptr)
+{
+    void *value = *ptr;
+    __dmb(0xF);
+    return value;
+}
+
+static __inline void AolkmeAtomic_StorePtr(void * volatile *ptr, void *value)
+{
+    __dmb(0xF);
+    *ptr = value;
+    __dmb(0xF);
+}
+
+static __inline bool AolkmeAtomic_CompareExchange32(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    __dmb(0xF);
+    do {
+        if (__ldrex(ptr) != expected) {
+            __clrex();
+            return false;
+        }
+    } while (__strex(desired, ptr) != 0);
+    __dmb(0xF);
+    return true;
+}
+
+#elif defined(__GNUC__) || defined(__clang__)
+
+#define AOLKME_ATOMIC_FENCE()                   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static __inline uint32_t AolkmeAtomic_Load32(const volatile uint32_t *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+static __inline void AolkmeAtomic_Store32(volatile uint32_t *ptr, uint32_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static __inline void *AolkmeAtomic_LoadPtr(void * volatile *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+static __inline void AolkmeAtomic_StorePtr(void * volatile *ptr, void *value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static __inline bool AolkmeAtomic_CompareExchange32(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#else
+#error "Aolkme_atomic.h: unsupported compiler"
+#endif
+
+
+/**
+ * @brief Atomically add value to *ptr (counters shared between tasks and interrupts).
+ *
+ * @return The new value of *ptr
+ */
+static __inline uint32_t AolkmeAtomic_Add32(volatile uint32_t *ptr, uint32_t value)
+{
+    uint32_t old;
+    do {
+        old = AolkmeAtomic_Load32(ptr);
+    } while (!AolkmeAtomic_CompareExchange32(ptr, old, old + value));
+    return old + value;
+}
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AOLKME_ATOMIC_H
@@ -11,55 +11,24 @@
 #define AOLKME_CORE_IMPLEMENTATION
 
 
-#include "Aolkme_event.h"
+#include "Aolkme_event_private.h"
 #include "Aolkme_core_private.h"
 
 
-#define EVENT_FLAG_DYNAMIC_DATA 0x01  ///< 事件数据为动态分配，需要释放
-
-
-// event system context
-typedef struct 
-{
-    // event handler
-    AolkmeEventHandler* handlers;
-    T_AolkmeEvent*                  queue;                     ///< Queue for storing events
-    T_AolkmeMutexHandle             mutex;                     ///< Mutex for synchronizing access to the event system
-    T_AolkmeSemaHandle              event_sem;                 ///< Semaphore for signaling event processing
-    T_AolkmeTaskHandle              task_handle;               ///< Task handle for event processing
-    
-    // queue
-    uint16_t                        queue_capacity;             ///< Maximum size of the event queue
-    uint16_t                        head;                       ///< Head pointer for the event queue
-    uint16_t                        tail;                       ///< Tail pointer for the event queue
-    // handler array
-    uint16_t                        handler_capacity;           ///< Maximum number of event handlers
-    uint16_t                        handler_count;              ///< Number of registered event handlers
-
-    
-    bool                            initialized;                  ///< Flag indicating if the event system is initialized
-    bool                            task_running;                 ///< Flag indicating if the event processing task is running
-
-} T_AolkmeEventSystemContext;
-
 // event system context
-static T_AolkmeEventSystemContext g_event_system_context = {0};
+T_AolkmeEventSystemContext g_event_system_context = {0};
 
 
 // Event processing task
 static void *event_processing_task(void* arg);
+static T_AolkmeReturnCode event_workers_start(const T_AolkmeEventSystemConfig* config);
+static T_AolkmeReturnCode event_publish(T_AolkmeEvent* event, uint8_t policy, uint32_t timeout_ms);
+static void event_workers_destroy(void);
 
 
 
 
 
-// 内部函数声明
-static T_AolkmeReturnCode event_system_lock(void);
-static T_AolkmeReturnCode event_system_unlock(void);
-static void free_event_data(T_AolkmeEvent* event);
-
-
-
 
 
 
@@ -76,7 +45,7 @@ T_AolkmeReturnCode AolkmeEvent_Init(const T_AolkmeEventSystemConfig* config)
         return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_HAS_BEEN_DONE;
     }
 
-    if (config == NULL || config->queue_size == 0 || config->max_handlers == 0) {
+    if (config == NULL || config->queue_size == 0 || (config->max_handlers == 0 && config->static_route_count == 0)) {
         return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
     }
 
@@ -92,56 +61,106 @@ T_AolkmeReturnCode AolkmeEvent_Init(const T_AolkmeEventSystemConfig* config)
         return AOLKME_ERROR_OSAL_MODULE_CODE_MUTEXCREATE_FAILED;
     }
 
-    returncode = osal_handler->SemaCreate(0, &g_event_system_context.event_sem);
+    // Initialize the workers' event queues
+    returncode = AolkmeEvent_QueueInit(config);
     if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_QueueDeinit();
         osal_handler->MutexDestroy(g_event_system_context.mutex);
         return returncode;
     }
 
-    // Initialize event queue
-    g_event_system_context.queue = (T_AolkmeEvent*)osal_handler->Malloc(config->queue_size * sizeof(T_AolkmeEvent));
-    if (g_event_system_context.queue == NULL) {
+    for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+        returncode = osal_handler->SemaCreate(0, &g_event_system_context.workers[i].event_sem);
+        if (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            returncode = osal_handler->SemaCreate(0, &g_event_system_context.workers[i].space_sem);
+        }
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            event_workers_destroy();
+            AolkmeEvent_QueueDeinit();
+            osal_handler->MutexDestroy(g_event_system_context.mutex);
+            return returncode;
+        }
+    }
+
+    // Carve the payload pool
+    returncode = AolkmeEvent_PoolInit(config->pools, config->pool_count);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        event_workers_destroy();
+        AolkmeEvent_QueueDeinit();
         osal_handler->MutexDestroy(g_event_system_context.mutex);
-        osal_handler->SemaDestroy(g_event_system_context.event_sem);
-        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+        return returncode;
     }
 
-    // Allocate memory for handlers
-    g_event_system_context.handlers = (AolkmeEventHandler*)osal_handler->Malloc(config->max_handlers * sizeof(AolkmeEventHandler));
-    if (g_event_system_context.handlers == NULL) {
-        osal_handler->Free(g_event_system_context.queue);
+    // Counters and the handler stats table (one entry per handler, at most one per route)
+    returncode = AolkmeEvent_StatsInit(config->max_handlers);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_StatsDeinit();
+        AolkmeEvent_PoolDeinit();
+        event_workers_destroy();
+        AolkmeEvent_QueueDeinit();
         osal_handler->MutexDestroy(g_event_system_context.mutex);
-        osal_handler->SemaDestroy(g_event_system_context.event_sem);
-        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+        return returncode;
     }
 
+    // Optional trace ring of dispatched events
+    returncode = AolkmeEvent_TraceInit(config->trace_size);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_StatsDeinit();
+        AolkmeEvent_PoolDeinit();
+        event_workers_destroy();
+        AolkmeEvent_QueueDeinit();
+        osal_handler->MutexDestroy(g_event_system_context.mutex);
+        return returncode;
+    }
+
+    // Reply slots of AolkmeEvent_Request, semaphores created once here
+    returncode = AolkmeEvent_ReplyInit();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_TraceDeinit();
+        AolkmeEvent_StatsDeinit();
+        AolkmeEvent_PoolDeinit();
+        event_workers_destroy();
+        AolkmeEvent_QueueDeinit();
+        osal_handler->MutexDestroy(g_event_system_context.mutex);
+        return returncode;
+    }
+
+    // Allocate the initial (empty) routing table snapshot, install the static routes
+    returncode = AolkmeEvent_RouteInit(config->max_handlers, config->static_routes, config->static_route_count);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_ReplyDeinit();
+        AolkmeEvent_TraceDeinit();
+        AolkmeEvent_StatsDeinit();
+        AolkmeEvent_PoolDeinit();
+        event_workers_destroy();
+        AolkmeEvent_QueueDeinit();
+        osal_handler->MutexDestroy(g_event_system_context.mutex);
+        return returncode;
+    }
+
+    AolkmeEvent_TimerInit();
+    AolkmeEvent_StickyInit();
+
     // Initialize event system context
-    g_event_system_context.handler_capacity = config->max_handlers;
-    g_event_system_context.queue_capacity = config->queue_size;
-    g_event_system_context.head = 0;
-    g_event_system_context.tail = 0;
-    g_event_system_context.handler_count = 0;
     g_event_system_context.initialized = true;
     g_event_system_context.task_running = false;
 
-    // Initialize event handlers
-    for (uint16_t i = 0; i < g_event_system_context.handler_capacity; i++) {
-        g_event_system_context.handlers[i] = NULL;
-    }
-
 
-    // Create event processing task if auto processing is enabled
+    // Create the event processing tasks if auto processing is enabled
     if (config->enable_auto_processing) {
-        returncode = osal_handler->TaskCreate("EventTask", event_processing_task, config->task_stack_size, NULL, &g_event_system_context.task_handle);
+        returncode = event_workers_start(config);
         if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
-            osal_handler->Free(g_event_system_context.handlers);
-            osal_handler->Free(g_event_system_context.queue);
+            AolkmeEvent_RouteDeinit();
+            AolkmeEvent_ReplyDeinit();
+            AolkmeEvent_TraceDeinit();
+            AolkmeEvent_StatsDeinit();
+            AolkmeEvent_PoolDeinit();
+            event_workers_destroy();
+            AolkmeEvent_QueueDeinit();
             osal_handler->MutexDestroy(g_event_system_context.mutex);
-            osal_handler->SemaDestroy(g_event_system_context.event_sem);
             memset(&g_event_system_context, 0, sizeof(g_event_system_context));
             return returncode;
         }
-        g_event_system_context.task_running = true;
     }
 
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
@@ -165,26 +184,33 @@ T_AolkmeReturnCode AolkmeEvent_Deinit(void)
     }
 
     if (g_event_system_context.task_running) {
-        // Signal the task to stop
+        // Signal the tasks to stop
         g_event_system_context.task_running = false;
-        osal_handler->SemaPost(g_event_system_context.event_sem);
+        for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+            osal_handler->SemaPost(g_event_system_context.workers[i].event_sem);
+        }
         osal_handler->TaskSleepMs(100);
     }
 
-    // Unregister all handlers
-    event_system_lock();
-    while (g_event_system_context.head != g_event_system_context.tail) {
-        T_AolkmeEvent* event = &g_event_system_context.queue[g_event_system_context.tail];
-        free_event_data(event);
-        g_event_system_context.tail = (g_event_system_context.tail + 1) % g_event_system_context.queue_capacity;
+    // Drop pending events
+    T_AolkmeEvent event;
+    for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+        while (AolkmeEvent_QueuePop(&g_event_system_context.workers[i], &event)) {
+            AolkmeEvent_FreeData(&event);
+        }
     }
-    event_system_unlock();
 
     // Clean up resources
-    osal_handler->Free(g_event_system_context.queue);
-    osal_handler->Free(g_event_system_context.handlers);
+    AolkmeEvent_TimerDeinit();
+    AolkmeEvent_StickyDeinit();
+    AolkmeEvent_PoolDeinit();
+    AolkmeEvent_RouteDeinit();
+    AolkmeEvent_ReplyDeinit();
+    AolkmeEvent_TraceDeinit();
+    AolkmeEvent_StatsDeinit();
+    event_workers_destroy();
+    AolkmeEvent_QueueDeinit();
     osal_handler->MutexDestroy(g_event_system_context.mutex);
-    osal_handler->SemaDestroy(g_event_system_context.event_sem);
 
     memset(&g_event_system_context, 0, sizeof(g_event_system_context));
 
@@ -203,167 +229,173 @@ T_AolkmeReturnCode AolkmeEvent_PublishEvent(T_AolkmeEvent* event)
         return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_HAS_BEEN_DONE;
     }
 
-    T_AolkmeOSALHandler* osal_handler = AolkmePlatform_GetOSALHandle();
-    if (osal_handler == NULL) {
-        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
-    }
+    uint32_t timeout_ms = 0;
+    uint8_t policy = AolkmeEvent_BackpressureRule(event->ID, &timeout_ms);
 
+    return event_publish(event, policy, timeout_ms);
+}
 
-    // Get current timestamp
-    uint32_t time_ms;
-    osal_handler->GetTimeMs(&time_ms);
-    event->timestamp = time_ms;
-
-    // Lock the mutex
-    T_AolkmeReturnCode returncode;
-    returncode = event_system_lock();
-    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
-        return returncode;
-    }
 
-    uint16_t next_head = (g_event_system_context.head + 1) % g_event_system_context.queue_capacity;
-    if (next_head == g_event_system_context.tail) {
-        event_system_unlock();
-        return AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL;
+/**
+ * @brief Publish an event with an explicit backpressure policy.
+ *
+ * @param event
+ * @param policy
+ * @param timeout_ms
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishEventPolicy(T_AolkmeEvent* event, E_AolkmeEventBackpressure policy, uint32_t timeout_ms)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
     }
 
-    // Publish the event
-    g_event_system_context.queue[g_event_system_context.head] = *event;
-    g_event_system_context.head = next_head;
-
-    event_system_unlock();
-
-    if (g_event_system_context.task_running) {
-        osal_handler->SemaPost(g_event_system_context.event_sem);
+    if (event == NULL || (uint32_t)policy > AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
     }
 
-    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    return event_publish(event, (uint8_t)policy, timeout_ms);
 }
 
 
 /**
- * @brief Subscribe to an event.
- * 
- * @param handler 
- * @return T_AolkmeReturnCode 
+ * @brief Publish an event from an interrupt handler.
+ *
+ * Uses no OSAL call except SemaPostFromISR, so it is safe in ISR context.
+ *
+ * @param event
+ * @param context_switch_required
+ * @return T_AolkmeReturnCode
  */
-T_AolkmeReturnCode AolkmeEvent_SubscribeEvent(AolkmeEventHandler handler)
+T_AolkmeReturnCode AolkmeEvent_PublishEventFromISR(T_AolkmeEvent* event, bool* context_switch_required)
 {
+    if (context_switch_required) {
+        *context_switch_required = false;
+    }
+
     if (!g_event_system_context.initialized) {
         return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
     }
 
-    if (handler == NULL) {
+    if (event == NULL) {
         return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
     }
 
-    // Lock the mutex
+    T_AolkmeEventWorker* worker = AolkmeEvent_QueueWorkerOf(event);
     T_AolkmeReturnCode returncode;
-    returncode = event_system_lock();
+    returncode = AolkmeEvent_QueuePushFromISR(worker, event);
     if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeAtomic_Add32(&g_event_system_context.counters.drop_isr_queue_full, 1);
         return returncode;
     }
+    AolkmeAtomic_Add32(&g_event_system_context.counters.publish_count, 1);
 
-    // Check if already subscribed
-    for (int i = 0; i < g_event_system_context.handler_capacity; i++) {
-        if (g_event_system_context.handlers[i] == handler) {
-            event_system_unlock();
-            return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS; // 已订阅视为成功
-        }
-    }
-
-    // Check for available slot
-    for (int i = 0; i < g_event_system_context.handler_capacity; i++) {
-        if (g_event_system_context.handlers[i] == NULL) {
-            g_event_system_context.handlers[i] = handler;
-            g_event_system_context.handler_count++;
-            event_system_unlock();
-            return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    // Without an ISR-safe post the event task finds the event on its next poll
+    T_AolkmeOSALHandler* osal_handler = AolkmePlatform_GetOSALHandle();
+    if (g_event_system_context.task_running && osal_handler != NULL && osal_handler->SemaPostFromISR != NULL) {
+        int woken = 0;
+        osal_handler->SemaPostFromISR(worker->event_sem, &woken);
+        if (context_switch_required) {
+            *context_switch_required = (woken != 0);
         }
     }
 
-    event_system_unlock();
-    return AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
 
 /**
- * @brief Unsubscribe from an event.
+ * @brief Get the status of the event system.
  * 
- * @param handler 
+ * @param queue_usage 
+ * @param handler_count 
  * @return T_AolkmeReturnCode 
  */
-T_AolkmeReturnCode AolkmeEvent_UnsubscribeEvent(AolkmeEventHandler handler)
+T_AolkmeReturnCode AolkmeEvent_GetStatus(uint8_t* queue_usage, uint8_t* handler_count) 
 {
     if (!g_event_system_context.initialized) {
         return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
     }
 
-    if (handler == NULL) {
-        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    if (queue_usage) {
+        uint32_t count = AolkmeEvent_QueueCount();
+        *queue_usage = (uint8_t)((count * 100) / g_event_system_context.queue_capacity);
     }
 
-    // Lock the mutex
     T_AolkmeReturnCode returnCode;
-    returnCode = event_system_lock();
+    returnCode = AolkmeEvent_Lock();
     if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
         return returnCode;
     }
 
-    // Find and remove the handler
-    for (int i = 0; i < g_event_system_context.handler_capacity; i++) {
-        if (g_event_system_context.handlers[i] == handler) {
-            g_event_system_context.handlers[i] = NULL;
-            g_event_system_context.handler_count--;
-            event_system_unlock();
-            return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
-        }
+    if (handler_count) {
+        *handler_count = (uint8_t)(g_event_system_context.route_table->route_count + g_event_system_context.static_route_count);
     }
 
-    event_system_unlock();
-    return AOLKME_ERROR_EVENT_MODULE_CODE_HANDLER_NOT_FOUND;
-}
-
-
-
+    returnCode = AolkmeEvent_Unlock();
+    if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returnCode;
+    }
 
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
 
 
 
 
 /**
- * @brief Get the status of the event system.
- * 
- * @param queue_usage 
- * @param handler_count 
- * @return T_AolkmeReturnCode 
+ * @brief Get the status of one priority lane.
+ *
+ * @param lane Lane index (= event priority, clamped to the configured lanes)
+ * @param status
+ * @return T_AolkmeReturnCode
  */
-T_AolkmeReturnCode AolkmeEvent_GetStatus(uint8_t* queue_usage, uint8_t* handler_count) 
+T_AolkmeReturnCode AolkmeEvent_GetLaneStatus(uint8_t lane, T_AolkmeEventLaneStatus* status)
 {
     if (!g_event_system_context.initialized) {
         return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
     }
 
-    T_AolkmeReturnCode returnCode;
-    returnCode = event_system_lock();
-    if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
-        return returnCode;
+    return AolkmeEvent_QueueLaneStatus(lane, status);
+}
+
+
+
+// ================= Publish ================= //
+
+static T_AolkmeReturnCode event_publish(T_AolkmeEvent* event, uint8_t policy, uint32_t timeout_ms)
+{
+    T_AolkmeOSALHandler* osal_handler = AolkmePlatform_GetOSALHandle();
+    if (osal_handler == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
     }
 
-    if (queue_usage) {
-        uint16_t count = (g_event_system_context.head >= g_event_system_context.tail) ?
-                         (g_event_system_context.head - g_event_system_context.tail) :
-                         (g_event_system_context.queue_capacity - g_event_system_context.tail + g_event_system_context.head);
-        *queue_usage = (uint8_t)((count * 100) / g_event_system_context.queue_capacity);
+
+    if (event->flags & EVENT_FLAG_RESERVED) {
+        AolkmeAtomic_Add32(&g_event_system_context.counters.drop_invalid, 1);
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
     }
 
-    if (handler_count) {
-        *handler_count = g_event_system_context.handler_count;
+    // Get current timestamp
+    uint32_t time_ms;
+    osal_handler->GetTimeMs(&time_ms);
+    event->timestamp = time_ms;
+
+    // Publish the event (takes the mutex only in AOLKME_EVENT_QUEUE_MUTEX mode), a full lane
+    // is handled by the backpressure policy
+    T_AolkmeEventWorker* worker = AolkmeEvent_QueueWorkerOf(event);
+    T_AolkmeReturnCode returncode;
+    returncode = AolkmeEvent_BackpressurePush(worker, event, policy, timeout_ms);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        if (returncode == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL && policy == AOLKME_EVENT_BACKPRESSURE_REJECT) {
+            AolkmeAtomic_Add32(&g_event_system_context.counters.drop_queue_full, 1);
+        }
+        return returncode;
     }
+    AolkmeAtomic_Add32(&g_event_system_context.counters.publish_count, 1);
 
-    returnCode = event_system_unlock();
-    if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
-        return returnCode;
+    if (g_event_system_context.task_running) {
+        osal_handler->SemaPost(worker->event_sem);
     }
 
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
@@ -371,52 +403,79 @@ T_AolkmeReturnCode AolkmeEvent_GetStatus(uint8_t* queue_usage, uint8_t* handler_
 
 
 
-
-
 // ================= Task Management ================= //
 
 static void *event_processing_task(void* arg)
 {
+    T_AolkmeEventWorker* worker = (T_AolkmeEventWorker*)arg;
+
     T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
     if (!osal) {
         return NULL;
     }
     
     while (g_event_system_context.task_running) {
+        // 第一个任务负责定时事件：发布到期的事件，并最多睡到下一个到期时间
+        uint32_t wait_ms = 100;
+        if (worker == &g_event_system_context.workers[0]) {
+            wait_ms = AolkmeEvent_TimerRun(wait_ms);
+        }
+
         // 等待事件或超时
-        osal->SemaTimedWait(g_event_system_context.event_sem, 100);
-
-        // 处理所有可用事件
-        while (g_event_system_context.task_running && (AolkmeCore_GetState() == AOLKME_CORE_STATE_RUNNING)) {
-            T_AolkmeEvent event;
-            bool has_event = false;
-            
-            // 从队列获取事件
-            if (event_system_lock() == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
-                if (g_event_system_context.tail != g_event_system_context.head) {
-                    event = g_event_system_context.queue[g_event_system_context.tail];
-                    g_event_system_context.tail = (g_event_system_context.tail + 1) % g_event_system_context.queue_capacity;
-                    has_event = true;
-                }
-                event_system_unlock();
+        osal->SemaTimedWait(worker->event_sem, wait_ms);
+
+        // 处理所有可用事件：每批最多 MAX_EVENT_SYSTEM_DISPATCH_BATCH 个，出队只加一次锁，
+        // 核心状态每批读取一次；每次发布都会唤醒任务，队列已空时不读取核心状态（它要加核心互斥锁）
+        while (g_event_system_context.task_running &&
+               (AolkmeAtomic_Load32(&worker->queued) != 0 ||
+                AolkmeAtomic_Load32(&g_event_system_context.sticky_delivery_count) != 0) &&
+               (AolkmeCore_GetState() == AOLKME_CORE_STATE_RUNNING)) {
+            T_AolkmeEvent batch[MAX_EVENT_SYSTEM_DISPATCH_BATCH];
+
+            // 新订阅者先收到缓存的粘性事件，再收到之后出队的事件
+            if (AolkmeAtomic_Load32(&g_event_system_context.sticky_delivery_count) != 0) {
+                AolkmeEvent_StickyDeliver(worker);
             }
-            
-            if (has_event) {
-                // 分发到所有订阅者
-                event_system_lock();
-                for (int i = 0; i < g_event_system_context.handler_capacity; i++) {
-                    if (g_event_system_context.handlers[i]) {
-                        g_event_system_context.handlers[i](event);
-                    }
-                }
-                event_system_unlock();
-                
-                // 释放事件数据
-                free_event_data(&event);
-            } else {
+
+            // 从队列获取一批事件
+            uint16_t count = AolkmeEvent_QueuePopBatch(worker, batch, MAX_EVENT_SYSTEM_DISPATCH_BATCH);
+            if (count == 0) {
                 // 没有更多事件，跳出内层循环
                 break;
             }
+
+            // 已出队的事件全部分发，即使任务正在停止，以免泄漏事件数据
+            for (uint16_t i = 0; i < count; i++) {
+                T_AolkmeEvent* event = &batch[i];
+
+                // 每个事件单独取时间：批内靠后的事件的延迟包含前面处理函数的耗时
+                uint32_t now_ms;
+                osal->GetTimeMs(&now_ms);
+
+                // 中断发布的事件可能没有时间戳
+                if (event->timestamp == 0) {
+                    event->timestamp = now_ms;
+                }
+                AolkmeEvent_StatsDispatched((now_ms - event->timestamp) * 1000u);
+
+                // 记录轨迹时测量全部处理函数的耗时
+                bool trace = g_event_system_context.trace_enabled;
+                uint32_t start_us = trace ? AolkmeEvent_StatsTimeUs() : 0;
+
+                // 只分发给订阅了该事件ID的处理函数（快照分发，不持有互斥锁，处理函数内可订阅/取消订阅）
+                const T_AolkmeEventRouteTable* table = AolkmeEvent_RouteAcquire(worker);
+                AolkmeEvent_RouteDispatch(table, event);
+                AolkmeEvent_RouteRelease(worker);
+
+                if (trace) {
+                    AolkmeEvent_TraceRecord(event, AolkmeEvent_StatsTimeUs() - start_us);
+                }
+
+                // 释放事件数据（粘性事件的数据由缓存接管）
+                if (!AolkmeEvent_StickyStore(event)) {
+                    AolkmeEvent_FreeData(event);
+                }
+            }
         }
     }
     
@@ -426,6 +485,67 @@ static void *event_processing_task(void* arg)
 }
 
 
+/**
+ * @brief Create one task per worker, pinned to its core when the platform supports it.
+ */
+static T_AolkmeReturnCode event_workers_start(const T_AolkmeEventSystemConfig* config)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    // Set before creating the tasks, they may run (and check the flag) before TaskCreate returns
+    g_event_system_context.task_running = true;
+
+    for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+        T_AolkmeEventWorker* worker = &g_event_system_context.workers[i];
+        int8_t core = config->worker_cores ? config->worker_cores[i] : -1;
+        T_AolkmeReturnCode returncode;
+
+        if (core >= 0 && osal->TaskCreatePinned != NULL) {
+            returncode = osal->TaskCreatePinned("EventTask", event_processing_task, config->task_stack_size, worker, core, &worker->task_handle);
+        } else {
+            returncode = osal->TaskCreate("EventTask", event_processing_task, config->task_stack_size, worker, &worker->task_handle);
+        }
+
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            // Stop the workers already running
+            g_event_system_context.task_running = false;
+            for (uint8_t n = 0; n < i; n++) {
+                osal->SemaPost(g_event_system_context.workers[n].event_sem);
+            }
+            if (i > 0) {
+                osal->TaskSleepMs(100);
+            }
+            return returncode;
+        }
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+static void event_workers_destroy(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal || g_event_system_context.workers == NULL) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+        if (g_event_system_context.workers[i].event_sem != NULL) {
+            osal->SemaDestroy(g_event_system_context.workers[i].event_sem);
+            g_event_system_context.workers[i].event_sem = NULL;
+        }
+        if (g_event_system_context.workers[i].space_sem != NULL) {
+            osal->SemaDestroy(g_event_system_context.workers[i].space_sem);
+            g_event_system_context.workers[i].space_sem = NULL;
+        }
+    }
+}
+
+
  
 
 
@@ -437,7 +557,7 @@ static void *event_processing_task(void* arg)
 
 // ================= 内部工具函数 ================= //
 
-static T_AolkmeReturnCode event_system_lock(void) {
+T_AolkmeReturnCode AolkmeEvent_Lock(void) {
     T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
     if (!osal) {
         return AOLKME_ERROR_PLATFORM_MODULE_CODE_INVALID_REQUEST_PARAMETER;
@@ -445,7 +565,7 @@ static T_AolkmeReturnCode event_system_lock(void) {
     return osal->MutexLock(g_event_system_context.mutex);
 }
 
-static T_AolkmeReturnCode event_system_unlock(void) {
+T_AolkmeReturnCode AolkmeEvent_Unlock(void) {
     T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
     if (!osal) {
         return AOLKME_ERROR_PLATFORM_MODULE_CODE_INVALID_REQUEST_PARAMETER;
@@ -453,8 +573,18 @@ static T_AolkmeReturnCode event_system_unlock(void) {
     return osal->MutexUnlock(g_event_system_context.mutex);
 }
 
-static void free_event_data(T_AolkmeEvent* event) {
+void AolkmeEvent_FreeData(T_AolkmeEvent* event) {
+    if (event->data && (event->flags & EVENT_FLAG_SHARED_DATA)) {
+        AolkmeEvent_SharedRelease(event->data);
+        return;
+    }
+
     if (event->data && (event->flags & EVENT_FLAG_DYNAMIC_DATA)) {
+        // Pool blocks go back to their size class, anything else was Malloc'd
+        if (AolkmeEvent_PoolRelease(event->data)) {
+            return;
+        }
+
         T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
         if (osal) {
             osal->Free(event->data);
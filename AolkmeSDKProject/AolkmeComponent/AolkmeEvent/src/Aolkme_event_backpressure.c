@@ -0,0 +1,230 @@
+/**
+ * @file Aolkme_event_backpressure.c
+ * @author Aolkme
+ * @brief 背压策略：通道已满时按发布或按事件ID选择阻塞等待、丢弃最旧、丢弃最新或丢弃最低优先级，
+ *        被丢弃事件的动态数据由事件系统释放，并按策略计数
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+#define EVENT_BACKPRESSURE_EVICT_RETRIES    4       // Evictions tried for one publish before dropping it
+
+
+
+static T_AolkmeReturnCode event_backpressure_block(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event, uint32_t timeout_ms);
+static volatile uint32_t* event_backpressure_counter(uint8_t policy);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Set the full-queue policy of one event ID.
+ *
+ * @param id
+ * @param policy
+ * @param timeout_ms
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SetBackpressure(E_AolkmeEventID id, E_AolkmeEventBackpressure policy, uint32_t timeout_ms)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if ((uint32_t)policy > AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    // Publishers scan the rules without the mutex, the count is only raised after the new entry is written
+    T_AolkmeEventBackpressureRule* rules = g_event_system_context.backpressure_rules;
+    uint32_t count = g_event_system_context.backpressure_rule_count;
+    uint32_t i = 0;
+    while (i < count && rules[i].id != id) {
+        i++;
+    }
+
+    if (policy != AOLKME_EVENT_BACKPRESSURE_REJECT) {
+        if (i < count || count < MAX_EVENT_SYSTEM_BACKPRESSURE_IDS) {
+            AolkmeAtomic_Store32(&rules[i].policy, (uint32_t)policy);
+            AolkmeAtomic_Store32(&rules[i].timeout_ms, timeout_ms);
+            if (i == count) {
+                AolkmeAtomic_Store32(&rules[i].id, id);
+                AolkmeAtomic_Store32(&g_event_system_context.backpressure_rule_count, count + 1);
+            }
+        } else {
+            returncode = AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+        }
+    } else if (i < count) {
+        AolkmeAtomic_Store32(&rules[i].id, rules[count - 1].id);
+        AolkmeAtomic_Store32(&rules[i].policy, rules[count - 1].policy);
+        AolkmeAtomic_Store32(&rules[i].timeout_ms, rules[count - 1].timeout_ms);
+        AolkmeAtomic_Store32(&g_event_system_context.backpressure_rule_count, count - 1);
+    }
+
+    AolkmeEvent_Unlock();
+    return returncode;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+uint8_t AolkmeEvent_BackpressureRule(E_AolkmeEventID id, uint32_t* timeout_ms)
+{
+    uint32_t count = AolkmeAtomic_Load32(&g_event_system_context.backpressure_rule_count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        T_AolkmeEventBackpressureRule* rule = &g_event_system_context.backpressure_rules[i];
+        if (AolkmeAtomic_Load32(&rule->id) == id) {
+            *timeout_ms = AolkmeAtomic_Load32(&rule->timeout_ms);
+            return (uint8_t)AolkmeAtomic_Load32(&rule->policy);
+        }
+    }
+    return AOLKME_EVENT_BACKPRESSURE_REJECT;
+}
+
+
+T_AolkmeReturnCode AolkmeEvent_BackpressurePush(T_AolkmeEventWorker* worker, T_AolkmeEvent* event, uint8_t policy, uint32_t timeout_ms)
+{
+    T_AolkmeReturnCode returncode = AolkmeEvent_QueuePush(worker, event);
+    if (returncode != AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL || policy == AOLKME_EVENT_BACKPRESSURE_REJECT) {
+        return returncode;
+    }
+
+    switch (policy) {
+        case AOLKME_EVENT_BACKPRESSURE_BLOCK:
+            returncode = event_backpressure_block(worker, event, timeout_ms);
+            break;
+
+        case AOLKME_EVENT_BACKPRESSURE_DROP_OLDEST:
+        case AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST:
+            // Another publisher may take the evicted slot first, then evict again. Bounded: in
+            // lock-free mode a preempted producer can hold the oldest slot unwritten.
+            for (uint8_t attempt = 0; attempt < EVENT_BACKPRESSURE_EVICT_RETRIES &&
+                 returncode == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL; attempt++) {
+                if (!AolkmeEvent_QueueEvict(worker, event, policy) && policy == AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST) {
+                    break;
+                }
+                returncode = AolkmeEvent_QueuePush(worker, event);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (returncode == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL || returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_TIMEOUT) {
+        // Dropped: the payload is ours, clear it so that a caller freeing on failure does nothing
+        AolkmeAtomic_Add32(event_backpressure_counter(policy), 1);
+        if (event->data != NULL && (event->flags & (EVENT_FLAG_DYNAMIC_DATA | EVENT_FLAG_SHARED_DATA))) {
+            AolkmeEvent_FreeData(event);
+            event->data = NULL;
+        }
+    }
+    return returncode;
+}
+
+
+void AolkmeEvent_BackpressureWake(T_AolkmeEventWorker* worker, uint16_t count)
+{
+    uint32_t blocked = AolkmeAtomic_Load32(&worker->blocked);
+    if (blocked == 0) {
+        return;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal || worker->space_sem == NULL) {
+        return;
+    }
+
+    // One post per freed slot, at most one per waiting publisher
+    for (uint32_t i = 0; i < blocked && i < count; i++) {
+        osal->SemaPost(worker->space_sem);
+    }
+}
+
+
+
+
+
+
+
+// ================= Helpers ================= //
+
+/**
+ * @brief Retry the push each time the worker dequeues, until timeout_ms has passed.
+ *
+ * The publisher counts itself in worker->blocked before retrying, so a slot freed between a
+ * failed push and the wait has already posted space_sem. Stale posts only cause a retry.
+ */
+static T_AolkmeReturnCode event_backpressure_block(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event, uint32_t timeout_ms)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    uint32_t start_ms;
+    osal->GetTimeMs(&start_ms);
+
+    T_AolkmeReturnCode returncode;
+    AolkmeAtomic_Add32(&worker->blocked, 1);
+
+    for (;;) {
+        returncode = AolkmeEvent_QueuePush(worker, event);
+        if (returncode != AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+            break;
+        }
+
+        if (timeout_ms == AOLKME_EVENT_WAIT_FOREVER) {
+            osal->SemaWait(worker->space_sem);
+            continue;
+        }
+
+        uint32_t now_ms;
+        osal->GetTimeMs(&now_ms);
+        if (now_ms - start_ms >= timeout_ms) {
+            returncode = AOLKME_ERROR_SYSTEM_MODULE_CODE_TIMEOUT;
+            break;
+        }
+        osal->SemaTimedWait(worker->space_sem, timeout_ms - (now_ms - start_ms));
+    }
+
+    AolkmeAtomic_Add32(&worker->blocked, (uint32_t)-1);
+    return returncode;
+}
+
+
+static volatile uint32_t* event_backpressure_counter(uint8_t policy)
+{
+    T_AolkmeEventCounters* counters = &g_event_system_context.counters;
+
+    switch (policy) {
+        case AOLKME_EVENT_BACKPRESSURE_BLOCK:       return &counters->drop_block_timeout;
+        case AOLKME_EVENT_BACKPRESSURE_DROP_OLDEST: return &counters->drop_oldest;
+        case AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST: return &counters->drop_lowest_priority;
+        default:                                    return &counters->drop_newest;
+    }
+}
@@ -0,0 +1,832 @@
+/**
+ * @file Aolkme_event_queue.c
+ * @author Aolkme
+ * @brief 事件队列：优先级通道（互斥锁环形队列 / 无锁多生产者环形队列），队列满时按背压策略淘汰事件
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+static uint8_t event_queue_lane_of(const T_AolkmeEvent* event);
+static T_AolkmeReturnCode event_queue_lane_push(T_AolkmeEventLane* lane, const T_AolkmeEvent* event);
+static bool event_queue_lane_pop(T_AolkmeEventLane* lane, T_AolkmeEvent* event);
+static bool event_queue_lane_evict_lowest(T_AolkmeEventLane* lane, uint8_t below, T_AolkmeEvent* event);
+static bool event_queue_select_pop(T_AolkmeEventWorker* worker, T_AolkmeEvent* event);
+static uint16_t event_queue_lane_count(const T_AolkmeEventLane* lane);
+static bool event_queue_is_coalesced(E_AolkmeEventID id);
+static T_AolkmeReturnCode event_queue_push_coalesced(T_AolkmeEventWorker* worker, T_AolkmeEventLane* lane, const T_AolkmeEvent* event);
+static void event_queue_resolve_coalesced(T_AolkmeEvent* event);
+static void event_queue_enqueued(T_AolkmeEventWorker* worker);
+static T_AolkmeReturnCode event_ring_init(T_AolkmeEventRing* ring, uint16_t capacity);
+static void event_ring_deinit(T_AolkmeEventRing* ring);
+static T_AolkmeReturnCode event_ring_push(T_AolkmeEventRing* ring, const T_AolkmeEvent* event);
+static bool event_ring_pop(T_AolkmeEventRing* ring, T_AolkmeEvent* event);
+static bool event_ring_take(T_AolkmeEventRing* ring, T_AolkmeEvent* event, uint8_t below);
+static uint16_t event_ring_count(const T_AolkmeEventRing* ring);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Enable or disable coalescing for one event ID.
+ *
+ * @param id
+ * @param enable
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SetCoalesce(E_AolkmeEventID id, bool enable)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    // Publishers scan the list without the mutex: entries are single words, and the count
+    // is only raised after the new entry is written
+    uint32_t count = g_event_system_context.coalesce_id_count;
+    uint32_t i = 0;
+    while (i < count && g_event_system_context.coalesce_ids[i] != id) {
+        i++;
+    }
+
+    if (enable && i == count) {
+        if (count < MAX_EVENT_SYSTEM_COALESCE_IDS) {
+            AolkmeAtomic_Store32(&g_event_system_context.coalesce_ids[count], id);
+            AolkmeAtomic_Store32(&g_event_system_context.coalesce_id_count, count + 1);
+        } else {
+            returncode = AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+        }
+    } else if (!enable && i < count) {
+        AolkmeAtomic_Store32(&g_event_system_context.coalesce_ids[i], g_event_system_context.coalesce_ids[count - 1]);
+        AolkmeAtomic_Store32(&g_event_system_context.coalesce_id_count, count - 1);
+    }
+
+    AolkmeEvent_Unlock();
+    return returncode;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+T_AolkmeReturnCode AolkmeEvent_QueueInit(const T_AolkmeEventSystemConfig* config)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    uint8_t mode = config->queue_mode;
+    uint8_t lane_count = config->priority_lanes ? config->priority_lanes : 1;
+    uint8_t worker_count = config->worker_count ? config->worker_count : 1;
+    if ((mode != AOLKME_EVENT_QUEUE_MUTEX && mode != AOLKME_EVENT_QUEUE_LOCKFREE) ||
+        lane_count > MAX_EVENT_SYSTEM_PRIORITY_LANES || worker_count > MAX_EVENT_SYSTEM_WORKERS) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    for (uint8_t i = 0; i < lane_count; i++) {
+        uint16_t size = config->lane_queue_sizes ? config->lane_queue_sizes[i] : config->queue_size;
+        if (size < 2) {
+            return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+        }
+    }
+
+    g_event_system_context.workers = (T_AolkmeEventWorker*)osal->Malloc(worker_count * sizeof(T_AolkmeEventWorker));
+    if (g_event_system_context.workers == NULL) {
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+    memset(g_event_system_context.workers, 0, worker_count * sizeof(T_AolkmeEventWorker));
+
+    g_event_system_context.worker_count = worker_count;
+    g_event_system_context.queue_mode = mode;
+    g_event_system_context.lane_count = lane_count;
+    g_event_system_context.weighted = (config->lane_weights != NULL);
+    g_event_system_context.queue_capacity = 0;
+    g_event_system_context.coalesce_id_count = 0;
+    memset(g_event_system_context.coalesce_slots, 0, sizeof(g_event_system_context.coalesce_slots));
+    g_event_system_context.backpressure_rule_count = 0;
+
+    T_AolkmeReturnCode returncode;
+    for (uint8_t w = 0; w < worker_count; w++) {
+        T_AolkmeEventWorker* worker = &g_event_system_context.workers[w];
+
+        // Interrupts cannot take the mutex, they always publish into their own lock-free ring
+        returncode = event_ring_init(&worker->isr_ring, MAX_EVENT_SYSTEM_ISR_QUEUE_SIZE);
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            return returncode;
+        }
+
+        worker->lanes = (T_AolkmeEventLane*)osal->Malloc(lane_count * sizeof(T_AolkmeEventLane));
+        if (worker->lanes == NULL) {
+            return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+        }
+        memset(worker->lanes, 0, lane_count * sizeof(T_AolkmeEventLane));
+
+        for (uint8_t i = 0; i < lane_count; i++) {
+            T_AolkmeEventLane* lane = &worker->lanes[i];
+
+            lane->capacity = config->lane_queue_sizes ? config->lane_queue_sizes[i] : config->queue_size;
+            if (config->lane_weights) {
+                // A zero weight would never be served while the other lanes are busy
+                lane->weight = config->lane_weights[i] ? config->lane_weights[i] : 1;
+                lane->credit = lane->weight;
+            }
+
+            if (mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+                returncode = event_ring_init(&lane->ring, lane->capacity);
+                if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+                    return returncode;
+                }
+            } else {
+                lane->queue = (T_AolkmeEvent*)osal->Malloc(lane->capacity * sizeof(T_AolkmeEvent));
+                if (lane->queue == NULL) {
+                    return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+                }
+            }
+
+            g_event_system_context.queue_capacity += lane->capacity;
+        }
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void AolkmeEvent_QueueDeinit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return;
+    }
+
+    if (g_event_system_context.workers == NULL) {
+        return;
+    }
+
+    for (uint8_t w = 0; w < g_event_system_context.worker_count; w++) {
+        T_AolkmeEventWorker* worker = &g_event_system_context.workers[w];
+
+        if (worker->lanes != NULL) {
+            for (uint8_t i = 0; i < g_event_system_context.lane_count; i++) {
+                T_AolkmeEventLane* lane = &worker->lanes[i];
+                if (lane->queue != NULL) {
+                    osal->Free(lane->queue);
+                }
+                event_ring_deinit(&lane->ring);
+            }
+            osal->Free(worker->lanes);
+        }
+        event_ring_deinit(&worker->isr_ring);
+    }
+
+    osal->Free(g_event_system_context.workers);
+    g_event_system_context.workers = NULL;
+    g_event_system_context.worker_count = 0;
+}
+
+
+T_AolkmeEventWorker* AolkmeEvent_QueueWorkerOf(const T_AolkmeEvent* event)
+{
+    if (g_event_system_context.worker_count == 1) {
+        return &g_event_system_context.workers[0];
+    }
+
+    // Fibonacci hashing spreads consecutive IDs of one category over the workers
+    uint32_t hash = (uint32_t)event->ID * 0x9E3779B1u;
+    return &g_event_system_context.workers[(hash >> 16) % g_event_system_context.worker_count];
+}
+
+
+T_AolkmeReturnCode AolkmeEvent_QueuePush(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event)
+{
+    T_AolkmeEventLane* lane = &worker->lanes[event_queue_lane_of(event)];
+    T_AolkmeReturnCode returncode;
+
+    // A request is never replaced, its requester waits for the reply
+    if (event->reply == 0 && event_queue_is_coalesced(event->ID)) {
+        return event_queue_push_coalesced(worker, lane, event);
+    }
+
+    if (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+        returncode = event_ring_push(&lane->ring, event);
+    } else {
+        // Lock the mutex
+        returncode = AolkmeEvent_Lock();
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            return returncode;
+        }
+
+        returncode = event_queue_lane_push(lane, event);
+
+        AolkmeEvent_Unlock();
+    }
+
+    if (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        event_queue_enqueued(worker);
+    } else if (returncode == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+        AolkmeAtomic_Add32(&lane->overflow_count, 1);
+    }
+    return returncode;
+}
+
+
+bool AolkmeEvent_QueueEvict(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event, uint8_t policy)
+{
+    T_AolkmeEventLane* lane = &worker->lanes[event_queue_lane_of(event)];
+    T_AolkmeEvent evicted;
+    bool found = false;
+    bool locked = false;
+
+    // DROP_OLDEST takes any priority, DROP_LOWEST only priorities below the new event's
+    uint8_t below = (policy == AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST) ?
+                    (uint8_t)EVENT_FLAG_GET_PRIORITY(event->flags) : MAX_EVENT_SYSTEM_PRIORITY_LANES;
+
+    if (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+        found = event_ring_take(&lane->ring, &evicted, below);
+    } else if (AolkmeEvent_Lock() == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        locked = true;
+        if (policy == AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST) {
+            found = event_queue_lane_evict_lowest(lane, below, &evicted);
+        } else {
+            found = event_queue_lane_pop(lane, &evicted);
+        }
+    }
+
+    // An evicted token drops the pending event of its coalesce slot
+    if (found && (evicted.flags & EVENT_FLAG_COALESCED_TOKEN)) {
+        if (!locked) {
+            locked = (AolkmeEvent_Lock() == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS);
+        }
+        if (locked) {
+            event_queue_resolve_coalesced(&evicted);
+        }
+    }
+
+    if (locked) {
+        AolkmeEvent_Unlock();
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    AolkmeAtomic_Add32(&worker->queued, (uint32_t)-1);
+    AolkmeEvent_StatsDequeued(1);
+    AolkmeAtomic_Add32((policy == AOLKME_EVENT_BACKPRESSURE_DROP_LOWEST) ?
+                       &g_event_system_context.counters.drop_lowest_priority :
+                       &g_event_system_context.counters.drop_oldest, 1);
+    AolkmeEvent_FreeData(&evicted);
+    return true;
+}
+
+
+T_AolkmeReturnCode AolkmeEvent_QueuePushFromISR(T_AolkmeEventWorker* worker, const T_AolkmeEvent* event)
+{
+    T_AolkmeReturnCode returncode = event_ring_push(&worker->isr_ring, event);
+    if (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        event_queue_enqueued(worker);
+    }
+    return returncode;
+}
+
+
+bool AolkmeEvent_QueuePop(T_AolkmeEventWorker* worker, T_AolkmeEvent* event)
+{
+    return AolkmeEvent_QueuePopBatch(worker, event, 1) == 1;
+}
+
+
+uint16_t AolkmeEvent_QueuePopBatch(T_AolkmeEventWorker* worker, T_AolkmeEvent* events, uint16_t max)
+{
+    uint16_t count = 0;
+
+    // Nothing published to this worker: skip the mutex. Every push posts event_sem after
+    // counting, so an event counted too late here is picked up on the next wake-up.
+    if (AolkmeAtomic_Load32(&worker->queued) == 0) {
+        return 0;
+    }
+
+    // Interrupt events first, they are never coalesced
+    while (count < max && event_ring_pop(&worker->isr_ring, &events[count])) {
+        count++;
+    }
+
+    if (count < max) {
+        // One mutex acquisition for the whole batch; in lock-free mode it is only taken
+        // when a coalesced token has to be resolved
+        bool locked = false;
+        if (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_MUTEX) {
+            locked = (AolkmeEvent_Lock() == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS);
+        }
+
+        if (locked || g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+            while (count < max && event_queue_select_pop(worker, &events[count])) {
+                if (events[count].flags & EVENT_FLAG_COALESCED_TOKEN) {
+                    if (!locked) {
+                        locked = (AolkmeEvent_Lock() == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS);
+                    }
+                    if (locked) {
+                        event_queue_resolve_coalesced(&events[count]);
+                    }
+                }
+                count++;
+            }
+        }
+
+        if (locked) {
+            AolkmeEvent_Unlock();
+        }
+    }
+
+    if (count > 0) {
+        AolkmeAtomic_Add32(&worker->queued, (uint32_t)0 - count);
+        AolkmeEvent_StatsDequeued(count);
+        AolkmeEvent_BackpressureWake(worker, count);
+    }
+    return count;
+}
+
+
+uint32_t AolkmeEvent_QueueCount(void)
+{
+    uint32_t count = 0;
+    for (uint8_t w = 0; w < g_event_system_context.worker_count; w++) {
+        count += event_ring_count(&g_event_system_context.workers[w].isr_ring);
+    }
+
+    bool locked = (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_MUTEX);
+    if (locked && AolkmeEvent_Lock() != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return count;
+    }
+
+    for (uint8_t w = 0; w < g_event_system_context.worker_count; w++) {
+        for (uint8_t i = 0; i < g_event_system_context.lane_count; i++) {
+            count += event_queue_lane_count(&g_event_system_context.workers[w].lanes[i]);
+        }
+    }
+
+    if (locked) {
+        AolkmeEvent_Unlock();
+    }
+    return count;
+}
+
+
+T_AolkmeReturnCode AolkmeEvent_QueueLaneStatus(uint8_t lane_index, T_AolkmeEventLaneStatus* status)
+{
+    if (lane_index >= g_event_system_context.lane_count || status == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    bool locked = (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_MUTEX);
+
+    if (locked) {
+        T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            return returncode;
+        }
+    }
+
+    memset(status, 0, sizeof(*status));
+    for (uint8_t w = 0; w < g_event_system_context.worker_count; w++) {
+        T_AolkmeEventLane* lane = &g_event_system_context.workers[w].lanes[lane_index];
+        status->capacity += lane->capacity - 1;
+        status->count += event_queue_lane_count(lane);
+        status->overflow_count += AolkmeAtomic_Load32(&lane->overflow_count);
+        status->coalesced_count += AolkmeAtomic_Load32(&lane->coalesced_count);
+    }
+
+    if (locked) {
+        AolkmeEvent_Unlock();
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+
+
+
+
+
+// ================= Priority Lanes ================= //
+
+/**
+ * @brief Lane of an event: its flags priority, clamped to the highest configured lane.
+ */
+static uint8_t event_queue_lane_of(const T_AolkmeEvent* event)
+{
+    uint8_t priority = (uint8_t)EVENT_FLAG_GET_PRIORITY(event->flags);
+    return (priority < g_event_system_context.lane_count) ? priority : (uint8_t)(g_event_system_context.lane_count - 1);
+}
+
+
+/**
+ * @brief Push to one lane. In mutex mode the caller holds the mutex.
+ */
+static T_AolkmeReturnCode event_queue_lane_push(T_AolkmeEventLane* lane, const T_AolkmeEvent* event)
+{
+    if (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+        return event_ring_push(&lane->ring, event);
+    }
+
+    uint16_t next_head = (lane->head + 1) % lane->capacity;
+    if (next_head == lane->tail) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL;
+    }
+
+    lane->queue[lane->head] = *event;
+    lane->head = next_head;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Pop from one lane. In mutex mode the caller holds the mutex.
+ */
+static bool event_queue_lane_pop(T_AolkmeEventLane* lane, T_AolkmeEvent* event)
+{
+    if (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+        return event_ring_pop(&lane->ring, event);
+    }
+
+    if (lane->tail == lane->head) {
+        return false;
+    }
+
+    *event = lane->queue[lane->tail];
+    lane->tail = (lane->tail + 1) % lane->capacity;
+    return true;
+}
+
+
+/**
+ * @brief Remove the oldest of the lowest-priority events of a lane, if that priority is below
+ * the given one, keeping the order of the others. Mutex mode, the caller holds the mutex.
+ */
+static bool event_queue_lane_evict_lowest(T_AolkmeEventLane* lane, uint8_t below, T_AolkmeEvent* event)
+{
+    uint16_t victim = lane->head;
+    uint8_t lowest = below;
+
+    for (uint16_t i = lane->tail; i != lane->head; i = (uint16_t)((i + 1) % lane->capacity)) {
+        uint8_t priority = (uint8_t)EVENT_FLAG_GET_PRIORITY(lane->queue[i].flags);
+        if (priority < lowest) {
+            lowest = priority;
+            victim = i;
+        }
+    }
+
+    if (victim == lane->head) {
+        return false;
+    }
+
+    *event = lane->queue[victim];
+
+    // Close the gap towards the head
+    for (uint16_t i = victim, next = (uint16_t)((victim + 1) % lane->capacity); next != lane->head;
+         i = next, next = (uint16_t)((next + 1) % lane->capacity)) {
+        lane->queue[i] = lane->queue[next];
+    }
+    lane->head = (uint16_t)((lane->head + lane->capacity - 1) % lane->capacity);
+    return true;
+}
+
+
+/**
+ * @brief Pick the lane to serve and pop from it.
+ *
+ * Strict priority: the highest non-empty lane always wins.
+ * Weighted: lanes are visited from the highest down and each serves up to its weight per
+ * round; once every lane with credit left is empty, the credits are refilled. Lower lanes
+ * thus keep a guaranteed share while the higher ones are saturated.
+ */
+static bool event_queue_select_pop(T_AolkmeEventWorker* worker, T_AolkmeEvent* event)
+{
+    T_AolkmeEventLane* lanes = worker->lanes;
+    uint8_t lane_count = g_event_system_context.lane_count;
+
+    if (!g_event_system_context.weighted) {
+        for (uint8_t i = lane_count; i > 0; i--) {
+            if (event_queue_lane_pop(&lanes[i - 1], event)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (uint8_t round = 0; round < 2; round++) {
+        for (uint8_t i = lane_count; i > 0; i--) {
+            T_AolkmeEventLane* lane = &lanes[i - 1];
+            if (lane->credit > 0 && event_queue_lane_pop(lane, event)) {
+                lane->credit--;
+                return true;
+            }
+        }
+
+        // Start a new round
+        for (uint8_t i = 0; i < lane_count; i++) {
+            lanes[i].credit = lanes[i].weight;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Events queued in one lane. In mutex mode the caller holds the mutex.
+ */
+static uint16_t event_queue_lane_count(const T_AolkmeEventLane* lane)
+{
+    if (g_event_system_context.queue_mode == AOLKME_EVENT_QUEUE_LOCKFREE) {
+        return event_ring_count(&lane->ring);
+    }
+
+    return (lane->head >= lane->tail) ?
+           (lane->head - lane->tail) :
+           (lane->capacity - lane->tail + lane->head);
+}
+
+
+
+
+
+
+
+
+// ================= Coalescing ================= //
+
+static bool event_queue_is_coalesced(E_AolkmeEventID id)
+{
+    uint32_t count = AolkmeAtomic_Load32(&g_event_system_context.coalesce_id_count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (AolkmeAtomic_Load32(&g_event_system_context.coalesce_ids[i]) == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Queue an event of a coalesced ID: last value wins.
+ *
+ * The pending event of each ID/source pair waits in a coalesce slot and the lane only holds a
+ * token pointing at it. A newer event of the same pair and priority overwrites the slot,
+ * keeping the token's place in the lane, and the older payload is freed. A different priority
+ * takes its own slot, so the event is queued in the lane of its priority. Without a free slot
+ * the event is queued normally.
+ *
+ * The slots are guarded by the mutex in both queue modes: replacing a whole event in place
+ * cannot be done with one word CAS. In AOLKME_EVENT_QUEUE_LOCKFREE mode coalesced IDs are
+ * therefore the only publishes taking the mutex, and the worker takes it when it dequeues
+ * one of their tokens.
+ */
+static T_AolkmeReturnCode event_queue_push_coalesced(T_AolkmeEventWorker* worker, T_AolkmeEventLane* lane, const T_AolkmeEvent* event)
+{
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    T_AolkmeEventCoalesceSlot* free_slot = NULL;
+    T_AolkmeEvent replaced;
+    bool has_replaced = false;
+
+    for (uint8_t i = 0; i < MAX_EVENT_SYSTEM_COALESCE_SLOTS; i++) {
+        T_AolkmeEventCoalesceSlot* slot = &g_event_system_context.coalesce_slots[i];
+        if (!slot->pending) {
+            if (free_slot == NULL) {
+                free_slot = slot;
+            }
+        } else if (slot->event.ID == event->ID && slot->event.source == event->source &&
+                   EVENT_FLAG_GET_PRIORITY(slot->event.flags) == EVENT_FLAG_GET_PRIORITY(event->flags)) {
+            // Same priority, hence the token sits in this lane
+            replaced = slot->event;
+            slot->event = *event;
+            has_replaced = true;
+            break;
+        }
+    }
+
+    if (has_replaced) {
+        AolkmeAtomic_Add32(&lane->coalesced_count, 1);
+    } else if (free_slot == NULL) {
+        returncode = event_queue_lane_push(lane, event);
+    } else {
+        T_AolkmeEvent token = *event;
+        token.data = free_slot;
+        token.flags = (uint8_t)((event->flags & EVENT_FLAG_PRIORITY_MASK) | EVENT_FLAG_COALESCED_TOKEN);
+
+        free_slot->event = *event;
+        returncode = event_queue_lane_push(lane, &token);
+        free_slot->pending = (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS);
+    }
+
+    AolkmeEvent_Unlock();
+
+    if (has_replaced) {
+        AolkmeEvent_FreeData(&replaced);
+    } else if (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        event_queue_enqueued(worker);
+    } else if (returncode == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+        AolkmeAtomic_Add32(&lane->overflow_count, 1);
+    }
+    return returncode;
+}
+
+
+/**
+ * @brief Swap a dequeued token for the latest event of its slot. The caller holds the mutex.
+ */
+static void event_queue_resolve_coalesced(T_AolkmeEvent* event)
+{
+    T_AolkmeEventCoalesceSlot* slot = (T_AolkmeEventCoalesceSlot*)event->data;
+
+    *event = slot->event;
+    slot->pending = false;
+}
+
+
+/**
+ * @brief An event took a slot of one of the worker's queues.
+ */
+static void event_queue_enqueued(T_AolkmeEventWorker* worker)
+{
+    AolkmeAtomic_Add32(&worker->queued, 1);
+    AolkmeEvent_StatsEnqueued();
+}
+
+
+
+
+
+
+
+
+// ================= Lock-free Ring ================= //
+
+/**
+ * @brief Allocate a ring holding capacity - 1 events, the same occupancy as the mutex ring.
+ *
+ * Slot index is position & mask, so the slot count must be a power of two for positions
+ * to stay consistent across the 32-bit wrap.
+ */
+static T_AolkmeReturnCode event_ring_init(T_AolkmeEventRing* ring, uint16_t capacity)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    uint32_t slot_count = 2;
+    while (slot_count < capacity) {
+        slot_count <<= 1;
+    }
+
+    ring->slots = (T_AolkmeEventQueueSlot*)osal->Malloc(slot_count * sizeof(T_AolkmeEventQueueSlot));
+    if (ring->slots == NULL) {
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < slot_count; i++) {
+        ring->slots[i].sequence = i;
+    }
+    ring->slot_mask = slot_count - 1;
+    ring->limit = (uint32_t)capacity - 1;
+    ring->enqueue_pos = 0;
+    ring->dequeue_pos = 0;
+    AOLKME_ATOMIC_FENCE();
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+static void event_ring_deinit(T_AolkmeEventRing* ring)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return;
+    }
+
+    if (ring->slots != NULL) {
+        osal->Free(ring->slots);
+        ring->slots = NULL;
+    }
+}
+
+
+/**
+ * @brief Claim a position with CAS, write the slot, then hand it to the consumer via its sequence.
+ *
+ * Producers never wait on each other: a failed CAS means another producer (or a nested
+ * interrupt) claimed the position and the loop retries with the next one.
+ */
+static T_AolkmeReturnCode event_ring_push(T_AolkmeEventRing* ring, const T_AolkmeEvent* event)
+{
+    for (;;) {
+        uint32_t pos = AolkmeAtomic_Load32(&ring->enqueue_pos);
+        int32_t used = (int32_t)(pos - AolkmeAtomic_Load32(&ring->dequeue_pos));
+
+        // Preempted between the loads: the consumer or an eviction moved dequeue_pos past
+        // the stale pos, which would read as a full ring
+        if (used < 0) {
+            continue;
+        }
+        if ((uint32_t)used >= ring->limit) {
+            return AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL;
+        }
+
+        T_AolkmeEventQueueSlot* slot = &ring->slots[pos & ring->slot_mask];
+        int32_t diff = (int32_t)(AolkmeAtomic_Load32(&slot->sequence) - pos);
+
+        if (diff == 0) {
+            if (AolkmeAtomic_CompareExchange32(&ring->enqueue_pos, pos, pos + 1)) {
+                slot->event = *event;
+                AolkmeAtomic_Store32(&slot->sequence, pos + 1);
+                return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+            }
+        } else if (diff < 0) {
+            // Slot still holds an event from the previous lap
+            return AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL;
+        }
+        // diff > 0: another producer already took pos, retry
+    }
+}
+
+
+/**
+ * @brief Read the oldest slot if its producer has finished writing it.
+ *
+ * A claimed but not yet written slot reads as empty; its producer posts the semaphore
+ * after writing, so the consumer picks it up on the next wake-up.
+ */
+static bool event_ring_pop(T_AolkmeEventRing* ring, T_AolkmeEvent* event)
+{
+    return event_ring_take(ring, event, MAX_EVENT_SYSTEM_PRIORITY_LANES);
+}
+
+
+/**
+ * @brief Take the oldest slot if it is written and its event's priority is below the given one.
+ *
+ * The worker and an evicting publisher may race for the same position: whoever wins the CAS
+ * on dequeue_pos owns the slot, which stays unreleased until its event is copied out. The
+ * priority is read before the CAS; if the slot was taken and rewritten meanwhile, dequeue_pos
+ * has moved and the CAS fails.
+ */
+static bool event_ring_take(T_AolkmeEventRing* ring, T_AolkmeEvent* event, uint8_t below)
+{
+    for (;;) {
+        uint32_t pos = AolkmeAtomic_Load32(&ring->dequeue_pos);
+        T_AolkmeEventQueueSlot* slot = &ring->slots[pos & ring->slot_mask];
+        int32_t diff = (int32_t)(AolkmeAtomic_Load32(&slot->sequence) - (pos + 1));
+
+        if (diff < 0) {
+            // Empty, or its producer is still writing it
+            return false;
+        }
+
+        if (diff == 0) {
+            if (EVENT_FLAG_GET_PRIORITY(slot->event.flags) >= below) {
+                return false;
+            }
+            if (AolkmeAtomic_CompareExchange32(&ring->dequeue_pos, pos, pos + 1)) {
+                *event = slot->event;
+                AolkmeAtomic_Store32(&slot->sequence, pos + ring->slot_mask + 1);
+                return true;
+            }
+        }
+        // diff > 0 or lost the CAS: pos was taken by someone else, retry
+    }
+}
+
+
+static uint16_t event_ring_count(const T_AolkmeEventRing* ring)
+{
+    uint32_t dequeue_pos = AolkmeAtomic_Load32(&ring->dequeue_pos);
+    uint32_t enqueue_pos = AolkmeAtomic_Load32(&ring->enqueue_pos);
+    return (uint16_t)(enqueue_pos - dequeue_pos);
+}
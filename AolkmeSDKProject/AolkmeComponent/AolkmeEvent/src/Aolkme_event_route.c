@@ -0,0 +1,926 @@
+/**
+ * @file Aolkme_event_route.c
+ * @author Aolkme
+ * @brief 事件路由表：按事件ID/ID范围/ID掩码订阅，写时复制快照
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+static T_AolkmeEventRouteTable* event_route_table_alloc(uint16_t capacity);
+static T_AolkmeEventRouteTable* event_route_table_clone(const T_AolkmeEventRouteTable* src);
+static void event_route_table_publish(T_AolkmeEventRouteTable* table);
+static void event_route_reclaim(void);
+static uint32_t event_route_reader_epoch(void);
+static T_AolkmeReturnCode event_route_add(T_AolkmeEventRouteTable* table, const T_AolkmeEventRoute* route);
+static uint16_t event_route_remove(T_AolkmeEventRouteTable* table, const T_AolkmeEventRoute* route, bool match_range);
+static void event_route_rebuild_index(T_AolkmeEventRouteTable* table);
+static void event_route_rebuild_mask_index(T_AolkmeEventRouteTable* table);
+static bool event_route_set_mask(T_AolkmeEventRoute* route, E_AolkmeEventID mask, E_AolkmeEventID value);
+static T_AolkmeReturnCode event_route_update(const T_AolkmeEventRoute* route, bool subscribe, bool match_range);
+static T_AolkmeReturnCode event_route_update_value(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventHandler handler, bool subscribe, bool match_range);
+static T_AolkmeReturnCode event_route_update_ref(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventRefHandler handler, bool subscribe, bool match_range);
+static T_AolkmeReturnCode event_route_update_mask(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventRefHandler handler, AolkmeEventHandler value_handler, bool subscribe);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Subscribe to all events.
+ *
+ * The handler is routed every event ID. Prefer AolkmeEvent_SubscribeEventId() or
+ * AolkmeEvent_SubscribeEventRange() so the handler is only called for the IDs it handles.
+ *
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEvent(AolkmeEventHandler handler)
+{
+    return AolkmeEvent_SubscribeEventRange(AOLKME_EVENT_ID_MIN, AOLKME_EVENT_ID_MAX, handler);
+}
+
+
+/**
+ * @brief Subscribe to a single event ID.
+ *
+ * @param id
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventId(E_AolkmeEventID id, AolkmeEventHandler handler)
+{
+    return AolkmeEvent_SubscribeEventRange(id, id, handler);
+}
+
+
+/**
+ * @brief Subscribe to every event ID in [first, last].
+ *
+ * May be called from inside an event handler; the new route applies from the next event.
+ *
+ * @param first First event ID of the range
+ * @param last Last event ID of the range (inclusive)
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventRange(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventHandler handler)
+{
+    return event_route_update_value(first, last, handler, true, true);
+}
+
+
+/**
+ * @brief Unsubscribe a handler from every event it is routed.
+ *
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEvent(AolkmeEventHandler handler)
+{
+    return event_route_update_value(AOLKME_EVENT_ID_MIN, AOLKME_EVENT_ID_MAX, handler, false, false);
+}
+
+
+/**
+ * @brief Unsubscribe a handler from a single event ID.
+ *
+ * @param id
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventId(E_AolkmeEventID id, AolkmeEventHandler handler)
+{
+    return AolkmeEvent_UnsubscribeEventRange(id, id, handler);
+}
+
+
+/**
+ * @brief Unsubscribe a handler from a range previously passed to AolkmeEvent_SubscribeEventRange().
+ *
+ * @param first
+ * @param last
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventRange(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventHandler handler)
+{
+    return event_route_update_value(first, last, handler, false, true);
+}
+
+
+/**
+ * @brief Subscribe to every event ID with (ID & mask) == value.
+ *
+ * E.g. every sensor event: mask AOLKME_EVENT_CATEGORY_MASK, value
+ * AOLKME_EVENT_CATEGORY_BASE(AOLKME_EVENT_CATEGORY_SENSOR).
+ *
+ * @param mask
+ * @param value
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventMask(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventHandler handler)
+{
+    return event_route_update_mask(mask, value, NULL, handler, true);
+}
+
+
+/**
+ * @brief Unsubscribe a handler from a mask previously passed to AolkmeEvent_SubscribeEventMask().
+ *
+ * @param mask
+ * @param value
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventMask(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventHandler handler)
+{
+    return event_route_update_mask(mask, value, NULL, handler, false);
+}
+
+
+/**
+ * @brief Subscribe a by-reference handler to all events.
+ *
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventRef(AolkmeEventRefHandler handler)
+{
+    return AolkmeEvent_SubscribeEventRangeRef(AOLKME_EVENT_ID_MIN, AOLKME_EVENT_ID_MAX, handler);
+}
+
+
+/**
+ * @brief Subscribe a by-reference handler to a single event ID.
+ *
+ * @param id
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventIdRef(E_AolkmeEventID id, AolkmeEventRefHandler handler)
+{
+    return AolkmeEvent_SubscribeEventRangeRef(id, id, handler);
+}
+
+
+/**
+ * @brief Subscribe a by-reference handler to every event ID in [first, last].
+ *
+ * @param first
+ * @param last
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventRangeRef(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventRefHandler handler)
+{
+    return event_route_update_ref(first, last, handler, true, true);
+}
+
+
+/**
+ * @brief Unsubscribe a by-reference handler from every event it is routed.
+ *
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventRef(AolkmeEventRefHandler handler)
+{
+    return event_route_update_ref(AOLKME_EVENT_ID_MIN, AOLKME_EVENT_ID_MAX, handler, false, false);
+}
+
+
+/**
+ * @brief Unsubscribe a by-reference handler from a single event ID.
+ *
+ * @param id
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventIdRef(E_AolkmeEventID id, AolkmeEventRefHandler handler)
+{
+    return AolkmeEvent_UnsubscribeEventRangeRef(id, id, handler);
+}
+
+
+/**
+ * @brief Unsubscribe a by-reference handler from a range.
+ *
+ * @param first
+ * @param last
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventRangeRef(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventRefHandler handler)
+{
+    return event_route_update_ref(first, last, handler, false, true);
+}
+
+
+/**
+ * @brief Subscribe a by-reference handler to every event ID with (ID & mask) == value.
+ *
+ * @param mask
+ * @param value
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SubscribeEventMaskRef(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventRefHandler handler)
+{
+    return event_route_update_mask(mask, value, handler, NULL, true);
+}
+
+
+/**
+ * @brief Unsubscribe a by-reference handler from a mask.
+ *
+ * @param mask
+ * @param value
+ * @param handler
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_UnsubscribeEventMaskRef(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventRefHandler handler)
+{
+    return event_route_update_mask(mask, value, handler, NULL, false);
+}
+
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+T_AolkmeReturnCode AolkmeEvent_RouteInit(uint16_t capacity, const T_AolkmeEventStaticRoute* static_routes, uint16_t static_count)
+{
+    // Static routes are used in place: check them once here, dispatch trusts them
+    uint32_t max_span = 0;
+    if (static_count > 0 && static_routes == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+    for (uint16_t i = 0; i < static_count; i++) {
+        const T_AolkmeEventStaticRoute* route = &static_routes[i];
+        if (route->handler == NULL || route->first > route->last ||
+            (i > 0 && route->first < static_routes[i - 1].first)) {
+            return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+        }
+        if (route->last - route->first > max_span) {
+            max_span = route->last - route->first;
+        }
+    }
+
+    T_AolkmeEventRouteTable* table = event_route_table_alloc(capacity);
+    if (table == NULL) {
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+
+    g_event_system_context.route_table = table;
+    g_event_system_context.route_retired = NULL;
+    g_event_system_context.route_epoch = 0;
+    g_event_system_context.route_reclaim_epoch = AOLKME_EVENT_EPOCH_IDLE;
+    for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+        g_event_system_context.workers[i].dispatch_epoch = AOLKME_EVENT_EPOCH_IDLE;
+    }
+    g_event_system_context.handler_capacity = capacity;
+
+    g_event_system_context.static_routes = (static_count > 0) ? static_routes : NULL;
+    g_event_system_context.static_route_count = static_count;
+    g_event_system_context.static_max_span = max_span;
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void AolkmeEvent_RouteDeinit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return;
+    }
+
+    T_AolkmeEventRouteTable* table = g_event_system_context.route_retired;
+    while (table != NULL) {
+        T_AolkmeEventRouteTable* next = table->next_retired;
+        osal->Free(table);
+        table = next;
+    }
+
+    osal->Free(g_event_system_context.route_table);
+    g_event_system_context.route_table = NULL;
+    g_event_system_context.route_retired = NULL;
+}
+
+
+const T_AolkmeEventRouteTable* AolkmeEvent_RouteAcquire(T_AolkmeEventWorker* worker)
+{
+    // Announce the epoch before loading the table: a writer that swaps after this point
+    // sees the announcement and keeps the table we are about to load.
+    uint32_t epoch = AolkmeAtomic_Load32(&g_event_system_context.route_epoch);
+    AolkmeAtomic_Store32(&worker->dispatch_epoch, epoch);
+    AOLKME_ATOMIC_FENCE();
+
+    return (const T_AolkmeEventRouteTable*)AolkmeAtomic_LoadPtr((void * volatile *)&g_event_system_context.route_table);
+}
+
+
+void AolkmeEvent_RouteRelease(T_AolkmeEventWorker* worker)
+{
+    AolkmeAtomic_Store32(&worker->dispatch_epoch, AOLKME_EVENT_EPOCH_IDLE);
+
+    // Retired tables only exist right after a (un)subscribe. The mutex is only taken once the
+    // oldest dispatch has moved past the oldest retired table, not while a long handler pins it.
+    if (AolkmeAtomic_LoadPtr((void * volatile *)&g_event_system_context.route_retired) != NULL &&
+        event_route_reader_epoch() >= AolkmeAtomic_Load32(&g_event_system_context.route_reclaim_epoch)) {
+        if (AolkmeEvent_Lock() == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            event_route_reclaim();
+            AolkmeEvent_Unlock();
+        }
+    }
+}
+
+
+/**
+ * @brief Call one route's handler. By-value handlers get a copy, which is the adapter that
+ * keeps the AolkmeEventHandler signature working.
+ */
+static __inline void event_route_call(const T_AolkmeEventRoute* route, const T_AolkmeEvent* event)
+{
+    uint32_t start = AolkmeEvent_StatsTimeUs();
+
+    if (route->handler != NULL) {
+        route->handler(event);
+    } else {
+        route->value_handler(*event);
+    }
+
+    AolkmeEvent_StatsHandlerTime(route->stats, AolkmeEvent_StatsTimeUs() - start);
+}
+
+
+/**
+ * @brief Call the static routes of event->ID.
+ *
+ * The table is sorted by first and no route is wider than static_max_span, so only routes
+ * starting in [ID - span, ID] can match: one binary search, then a scan of that window
+ * (exactly the routes of the ID when the table holds single IDs only).
+ */
+static __inline void event_route_dispatch_static(const T_AolkmeEvent* event)
+{
+    const T_AolkmeEventStaticRoute* routes = g_event_system_context.static_routes;
+    uint16_t count = g_event_system_context.static_route_count;
+    E_AolkmeEventID id = event->ID;
+    E_AolkmeEventID from = (id > g_event_system_context.static_max_span) ? id - g_event_system_context.static_max_span : 0;
+
+    uint16_t lo = 0;
+    uint16_t hi = count;
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (routes[mid].first < from) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (uint16_t i = lo; i < count && routes[i].first <= id; i++) {
+        if (id <= routes[i].last) {
+            routes[i].handler(event);
+        }
+    }
+}
+
+
+/**
+ * @brief Call the mask routes of event->ID: per distinct mask, one AND and one binary search
+ * for the first route with that value.
+ */
+static __inline void event_route_dispatch_masks(const T_AolkmeEventRouteTable* table, const T_AolkmeEvent* event)
+{
+    const T_AolkmeEventRoute* routes = table->routes;
+
+    for (uint8_t m = 0; m < table->mask_index_count; m++) {
+        const T_AolkmeEventMaskIndex* index = &table->masks[m];
+        E_AolkmeEventID value = event->ID & index->mask;
+        uint16_t end = index->start + index->count;
+
+        uint16_t lo = index->start;
+        uint16_t hi = end;
+        while (lo < hi) {
+            uint16_t mid = (uint16_t)((lo + hi) / 2);
+            if (routes[mid].first < value) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        for (uint16_t i = lo; i < end && routes[i].first == value; i++) {
+            event_route_call(&routes[i], event);
+        }
+    }
+}
+
+
+/**
+ * @brief Call every handler routed to event->ID: static routes first, then runtime ones.
+ *
+ * Cost is one binary search over the categories plus the routes of the event's own category,
+ * plus one binary search per distinct subscription mask, independent of how many handlers are
+ * registered for other events.
+ */
+void AolkmeEvent_RouteDispatch(const T_AolkmeEventRouteTable* table, const T_AolkmeEvent* event)
+{
+    const T_AolkmeEventRoute* routes = table->routes;
+    E_AolkmeEventID id = event->ID;
+
+    if (g_event_system_context.static_route_count > 0) {
+        event_route_dispatch_static(event);
+    }
+
+    // Routes spanning several categories
+    for (uint16_t i = table->capacity - table->wide_count; i < table->capacity - table->mask_count; i++) {
+        if (id >= routes[i].first && id <= routes[i].last) {
+            event_route_call(&routes[i], event);
+        }
+    }
+
+    if (table->mask_index_count > 0) {
+        event_route_dispatch_masks(table, event);
+    }
+
+    // Binary search the category index
+    uint16_t category = (uint16_t)AOLKME_EVENT_CATEGORY(id);
+    uint16_t lo = 0;
+    uint16_t hi = table->category_count;
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (table->categories[mid].category < category) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == table->category_count || table->categories[lo].category != category) {
+        return;
+    }
+
+    // Routes are sorted by first ID, stop at the first one starting after the event
+    const T_AolkmeEventCategoryIndex* index = &table->categories[lo];
+    for (uint16_t i = index->start; i < index->start + index->count; i++) {
+        if (routes[i].first > id) {
+            break;
+        }
+        if (id <= routes[i].last) {
+            event_route_call(&routes[i], event);
+        }
+    }
+}
+
+
+
+
+
+
+
+
+// ================= Snapshot Management ================= //
+
+/**
+ * @brief Apply one subscribe/unsubscribe to a copy of the current table and publish the copy.
+ */
+static T_AolkmeReturnCode event_route_update(const T_AolkmeEventRoute* route, bool subscribe, bool match_range)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if ((route->handler == NULL && route->value_handler == NULL) || route->first > route->last) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    // Lock the mutex, serializes writers only
+    T_AolkmeReturnCode returncode;
+    returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    T_AolkmeEventRouteTable* table = event_route_table_clone(g_event_system_context.route_table);
+    if (table == NULL) {
+        AolkmeEvent_Unlock();
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+
+    if (subscribe) {
+        returncode = event_route_add(table, route);
+    } else if (event_route_remove(table, route, match_range) == 0) {
+        returncode = AOLKME_ERROR_EVENT_MODULE_CODE_HANDLER_NOT_FOUND;
+    }
+
+    if (returncode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+        table->route_count != g_event_system_context.route_table->route_count) {
+        event_route_table_publish(table);
+        if (subscribe) {
+            // Hand the cached sticky events to the new subscriber
+            AolkmeEvent_StickySubscribed(route);
+        }
+    } else {
+        // Error or already subscribed: nothing changed
+        osal->Free(table);
+    }
+
+    AolkmeEvent_Unlock();
+    return returncode;
+}
+
+
+static T_AolkmeReturnCode event_route_update_value(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventHandler handler, bool subscribe, bool match_range)
+{
+    T_AolkmeEventRoute route = { .first = first, .last = last, .handler = NULL, .value_handler = handler, .stats = AOLKME_EVENT_STATS_NONE };
+    if (handler == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+    return event_route_update(&route, subscribe, match_range);
+}
+
+
+static T_AolkmeReturnCode event_route_update_ref(E_AolkmeEventID first, E_AolkmeEventID last, AolkmeEventRefHandler handler, bool subscribe, bool match_range)
+{
+    T_AolkmeEventRoute route = { .first = first, .last = last, .handler = handler, .value_handler = NULL, .stats = AOLKME_EVENT_STATS_NONE };
+    if (handler == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+    return event_route_update(&route, subscribe, match_range);
+}
+
+
+static T_AolkmeReturnCode event_route_update_mask(E_AolkmeEventID mask, E_AolkmeEventID value, AolkmeEventRefHandler handler, AolkmeEventHandler value_handler, bool subscribe)
+{
+    T_AolkmeEventRoute route = { .handler = handler, .value_handler = value_handler, .stats = AOLKME_EVENT_STATS_NONE };
+    if ((handler == NULL && value_handler == NULL) || !event_route_set_mask(&route, mask, value)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+    return event_route_update(&route, subscribe, true);
+}
+
+
+/**
+ * @brief Fill first/last/mask of a mask subscription.
+ *
+ * A mask of leading ones matches one contiguous range, e.g. a whole category: it becomes a
+ * plain range route and uses the category index. Other masks keep first = value and
+ * last = the highest matching ID, so [first, last] bounds the IDs they match.
+ *
+ * @return false if value has bits outside mask
+ */
+static bool event_route_set_mask(T_AolkmeEventRoute* route, E_AolkmeEventID mask, E_AolkmeEventID value)
+{
+    E_AolkmeEventID free_bits = ~mask;
+
+    if ((value & free_bits) != 0) {
+        return false;
+    }
+
+    route->first = value;
+    route->last = value | free_bits;
+    route->mask = ((free_bits & (free_bits + 1)) == 0) ? 0 : mask;
+    return true;
+}
+
+
+static T_AolkmeEventRouteTable* event_route_table_alloc(uint16_t capacity)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return NULL;
+    }
+
+    // Header, routes and category index in one block
+    uint32_t size = sizeof(T_AolkmeEventRouteTable) +
+                    capacity * sizeof(T_AolkmeEventRoute) +
+                    capacity * sizeof(T_AolkmeEventCategoryIndex);
+    T_AolkmeEventRouteTable* table = (T_AolkmeEventRouteTable*)osal->Malloc(size);
+    if (table == NULL) {
+        return NULL;
+    }
+
+    memset(table, 0, size);
+    table->routes = (T_AolkmeEventRoute*)(table + 1);
+    table->categories = (T_AolkmeEventCategoryIndex*)(table->routes + capacity);
+    table->capacity = capacity;
+
+    return table;
+}
+
+
+static T_AolkmeEventRouteTable* event_route_table_clone(const T_AolkmeEventRouteTable* src)
+{
+    T_AolkmeEventRouteTable* table = event_route_table_alloc(src->capacity);
+    if (table == NULL) {
+        return NULL;
+    }
+
+    memcpy(table->routes, src->routes, src->capacity * sizeof(T_AolkmeEventRoute));
+    memcpy(table->categories, src->categories, src->category_count * sizeof(T_AolkmeEventCategoryIndex));
+    table->route_count = src->route_count;
+    table->local_count = src->local_count;
+    table->wide_count = src->wide_count;
+    table->category_count = src->category_count;
+    table->mask_count = src->mask_count;
+    table->mask_index_count = src->mask_index_count;
+    memcpy(table->masks, src->masks, sizeof(table->masks));
+
+    return table;
+}
+
+
+/**
+ * @brief Make table the current snapshot and retire the previous one. Caller holds the mutex.
+ */
+static void event_route_table_publish(T_AolkmeEventRouteTable* table)
+{
+    T_AolkmeEventRouteTable* old = g_event_system_context.route_table;
+
+    AolkmeAtomic_StorePtr((void * volatile *)&g_event_system_context.route_table, table);
+
+    uint32_t epoch = g_event_system_context.route_epoch + 1;
+    AolkmeAtomic_Store32(&g_event_system_context.route_epoch, epoch);
+
+    old->retire_epoch = epoch;
+    old->next_retired = g_event_system_context.route_retired;
+    AolkmeAtomic_StorePtr((void * volatile *)&g_event_system_context.route_retired, old);
+
+    event_route_reclaim();
+}
+
+
+/**
+ * @brief Free retired tables no event worker can still be reading. Caller holds the mutex.
+ *
+ * A dispatch that announced epoch E loaded the table current at E, so every table
+ * retired at an epoch above E may still be in use; everything else is safe to free.
+ */
+static void event_route_reclaim(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return;
+    }
+
+    uint32_t reader = event_route_reader_epoch();
+    uint32_t oldest = AOLKME_EVENT_EPOCH_IDLE;
+
+    T_AolkmeEventRouteTable* volatile* link = &g_event_system_context.route_retired;
+    while (*link != NULL) {
+        T_AolkmeEventRouteTable* table = *link;
+        if (reader == AOLKME_EVENT_EPOCH_IDLE || reader >= table->retire_epoch) {
+            *link = table->next_retired;
+            osal->Free(table);
+        } else {
+            if (table->retire_epoch < oldest) {
+                oldest = table->retire_epoch;
+            }
+            link = &table->next_retired;
+        }
+    }
+
+    // Read lock-free by AolkmeEvent_RouteRelease to decide whether reclaiming can free anything
+    AolkmeAtomic_Store32(&g_event_system_context.route_reclaim_epoch, oldest);
+}
+
+
+/**
+ * @brief Oldest epoch any worker is still dispatching from, AOLKME_EVENT_EPOCH_IDLE if none.
+ */
+static uint32_t event_route_reader_epoch(void)
+{
+    uint32_t reader = AOLKME_EVENT_EPOCH_IDLE;
+
+    for (uint8_t i = 0; i < g_event_system_context.worker_count; i++) {
+        uint32_t epoch = AolkmeAtomic_Load32(&g_event_system_context.workers[i].dispatch_epoch);
+        if (epoch < reader) {
+            reader = epoch;
+        }
+    }
+    return reader;
+}
+
+
+
+
+
+
+
+
+// ================= Routing Table ================= //
+
+static bool event_route_is_local(E_AolkmeEventID first, E_AolkmeEventID last)
+{
+    return AOLKME_EVENT_CATEGORY(first) == AOLKME_EVENT_CATEGORY(last);
+}
+
+static bool event_route_same_handler(const T_AolkmeEventRoute* a, const T_AolkmeEventRoute* b)
+{
+    return a->handler == b->handler && a->value_handler == b->value_handler;
+}
+
+static bool event_route_same_range(const T_AolkmeEventRoute* a, const T_AolkmeEventRoute* b)
+{
+    return a->first == b->first && a->last == b->last && a->mask == b->mask;
+}
+
+/**
+ * @brief Insert a route, keeping the local routes sorted by first ID and the mask routes by
+ * mask, then value.
+ */
+static T_AolkmeReturnCode event_route_add(T_AolkmeEventRouteTable* table, const T_AolkmeEventRoute* route)
+{
+    E_AolkmeEventID first = route->first;
+    E_AolkmeEventID last = route->last;
+    T_AolkmeEventRoute* routes = table->routes;
+    uint16_t wide_start = table->capacity - table->wide_count;
+    uint16_t mask_start = table->capacity - table->mask_count;
+
+    // Check if already subscribed
+    for (uint16_t i = 0; i < table->capacity; i++) {
+        if ((i < table->local_count || i >= wide_start) &&
+            event_route_same_handler(&routes[i], route) && event_route_same_range(&routes[i], route)) {
+            return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS; // 已订阅视为成功
+        }
+    }
+
+    if (table->route_count >= table->capacity) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+    }
+
+    if (route->mask != 0) {
+        bool known = false;
+        for (uint8_t m = 0; m < table->mask_index_count; m++) {
+            known = known || (table->masks[m].mask == route->mask);
+        }
+        if (!known && table->mask_index_count >= MAX_EVENT_SYSTEM_ROUTE_MASKS) {
+            return AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+        }
+    }
+
+    bool local = (route->mask == 0) && event_route_is_local(first, last);
+    uint16_t pos;
+    if (route->mask != 0) {
+        // Mask routes are the tail of the wide routes: shift the ones ordered before it down
+        pos = mask_start;
+        while (pos < table->capacity && (routes[pos].mask < route->mask ||
+               (routes[pos].mask == route->mask && routes[pos].first <= first))) {
+            pos++;
+        }
+        for (uint16_t i = wide_start; i < pos; i++) {
+            routes[i - 1] = routes[i];
+        }
+        pos--;
+        table->wide_count++;
+        table->mask_count++;
+    } else if (!local) {
+        // Before the mask routes
+        for (uint16_t i = wide_start; i < mask_start; i++) {
+            routes[i - 1] = routes[i];
+        }
+        pos = mask_start - 1;
+        table->wide_count++;
+    } else {
+        pos = table->local_count;
+        while (pos > 0 && routes[pos - 1].first > first) {
+            routes[pos] = routes[pos - 1];
+            pos--;
+        }
+        table->local_count++;
+    }
+
+    routes[pos] = *route;
+    routes[pos].stats = AolkmeEvent_StatsHandlerSlot(route->handler, route->value_handler);
+
+    if (local) {
+        event_route_rebuild_index(table);
+    } else if (route->mask != 0) {
+        event_route_rebuild_mask_index(table);
+    }
+
+    table->route_count++;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * @brief Remove routes of a handler.
+ *
+ * @param match_range true: only the route [first, last]; false: every route of the handler
+ * @return uint16_t Number of routes removed
+ */
+static uint16_t event_route_remove(T_AolkmeEventRouteTable* table, const T_AolkmeEventRoute* route, bool match_range)
+{
+    T_AolkmeEventRoute* routes = table->routes;
+    uint16_t capacity = table->capacity;
+    uint16_t removed_local = 0;
+    uint16_t removed_wide = 0;
+
+    // Compact local routes, order is preserved
+    uint16_t out = 0;
+    for (uint16_t i = 0; i < table->local_count; i++) {
+        bool hit = event_route_same_handler(&routes[i], route) &&
+                   (!match_range || event_route_same_range(&routes[i], route));
+        if (hit) {
+            removed_local++;
+        } else {
+            routes[out++] = routes[i];
+        }
+    }
+    table->local_count = out;
+
+    // Compact wide routes towards the end of the array, mask routes stay last and sorted
+    uint16_t wide_start = capacity - table->wide_count;
+    uint16_t removed_mask = 0;
+    out = capacity;
+    for (uint16_t i = capacity; i > wide_start; i--) {
+        bool hit = event_route_same_handler(&routes[i - 1], route) &&
+                   (!match_range || event_route_same_range(&routes[i - 1], route));
+        if (hit) {
+            removed_wide++;
+            removed_mask += (routes[i - 1].mask != 0) ? 1 : 0;
+        } else {
+            routes[--out] = routes[i - 1];
+        }
+    }
+    table->wide_count = capacity - out;
+
+    if (removed_local > 0) {
+        event_route_rebuild_index(table);
+    }
+    if (removed_mask > 0) {
+        table->mask_count -= removed_mask;
+        event_route_rebuild_mask_index(table);
+    }
+
+    table->route_count -= (removed_local + removed_wide);
+    return removed_local + removed_wide;
+}
+
+/**
+ * @brief Rebuild the category index from the sorted local routes.
+ */
+static void event_route_rebuild_index(T_AolkmeEventRouteTable* table)
+{
+    T_AolkmeEventRoute* routes = table->routes;
+    T_AolkmeEventCategoryIndex* categories = table->categories;
+    uint16_t count = 0;
+
+    for (uint16_t i = 0; i < table->local_count; i++) {
+        uint16_t category = (uint16_t)AOLKME_EVENT_CATEGORY(routes[i].first);
+        if (count == 0 || categories[count - 1].category != category) {
+            categories[count].category = category;
+            categories[count].start = i;
+            categories[count].count = 0;
+            count++;
+        }
+        categories[count - 1].count++;
+    }
+
+    table->category_count = count;
+}
+
+/**
+ * @brief Rebuild the mask index from the sorted mask routes.
+ */
+static void event_route_rebuild_mask_index(T_AolkmeEventRouteTable* table)
+{
+    T_AolkmeEventRoute* routes = table->routes;
+    T_AolkmeEventMaskIndex* masks = table->masks;
+    uint8_t count = 0;
+
+    for (uint16_t i = table->capacity - table->mask_count; i < table->capacity; i++) {
+        if (count == 0 || masks[count - 1].mask != routes[i].mask) {
+            masks[count].mask = routes[i].mask;
+            masks[count].start = i;
+            masks[count].count = 0;
+            count++;
+        }
+        masks[count - 1].count++;
+    }
+
+    table->mask_index_count = count;
+}
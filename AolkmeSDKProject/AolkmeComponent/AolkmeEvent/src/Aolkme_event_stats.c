@@ -0,0 +1,298 @@
+/**
+ * @file Aolkme_event_stats.c
+ * @author Aolkme
+ * @brief 事件系统统计：发布/丢弃计数、队列峰值深度、分发延迟直方图、处理函数耗时
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+static uint8_t event_stats_bucket(uint32_t latency_us);
+static void event_stats_max(volatile uint32_t* max, uint32_t value);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Get the event system counters.
+ *
+ * @param stats
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_GetStats(T_AolkmeEventStats* stats)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (stats == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeEventCounters* counters = &g_event_system_context.counters;
+
+    stats->publish_count = AolkmeAtomic_Load32(&counters->publish_count);
+    stats->dispatch_count = AolkmeAtomic_Load32(&counters->dispatch_count);
+    stats->drop_queue_full = AolkmeAtomic_Load32(&counters->drop_queue_full);
+    stats->drop_isr_queue_full = AolkmeAtomic_Load32(&counters->drop_isr_queue_full);
+    stats->drop_invalid = AolkmeAtomic_Load32(&counters->drop_invalid);
+    stats->drop_block_timeout = AolkmeAtomic_Load32(&counters->drop_block_timeout);
+    stats->drop_oldest = AolkmeAtomic_Load32(&counters->drop_oldest);
+    stats->drop_newest = AolkmeAtomic_Load32(&counters->drop_newest);
+    stats->drop_lowest_priority = AolkmeAtomic_Load32(&counters->drop_lowest_priority);
+    stats->queue_depth = AolkmeAtomic_Load32(&counters->queue_depth);
+    stats->peak_queue_depth = AolkmeAtomic_Load32(&counters->peak_queue_depth);
+
+    stats->coalesced_count = 0;
+    for (uint8_t i = 0; i < g_event_system_context.lane_count; i++) {
+        T_AolkmeEventLaneStatus lane;
+        if (AolkmeEvent_QueueLaneStatus(i, &lane) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            stats->coalesced_count += lane.coalesced_count;
+        }
+    }
+
+    for (uint8_t i = 0; i < AOLKME_EVENT_LATENCY_BUCKETS; i++) {
+        stats->latency_histogram[i] = AolkmeAtomic_Load32(&counters->latency_histogram[i]);
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Get the execution time of one handler.
+ *
+ * Handlers get an entry the first time they subscribe and keep it after unsubscribing, so a
+ * caller can walk index 0, 1, ... until INVALID_PARAMETER is returned.
+ *
+ * @param index
+ * @param stats
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_GetHandlerStats(uint16_t index, T_AolkmeEventHandlerStats* stats)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (stats == NULL || index >= AolkmeAtomic_Load32(&g_event_system_context.handler_stats_count)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeEventHandlerStatsSlot* slot = &g_event_system_context.handler_stats[index];
+    stats->handler = slot->handler;
+    stats->value_handler = slot->value_handler;
+    stats->call_count = AolkmeAtomic_Load32(&slot->call_count);
+    stats->total_time_us = AolkmeAtomic_Load32(&slot->total_time_us);
+    stats->max_time_us = AolkmeAtomic_Load32(&slot->max_time_us);
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Zero all counters, histograms and handler times. Handler entries are kept.
+ *
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_ResetStats(void)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeEventCounters* counters = &g_event_system_context.counters;
+
+    AolkmeAtomic_Store32(&counters->publish_count, 0);
+    AolkmeAtomic_Store32(&counters->dispatch_count, 0);
+    AolkmeAtomic_Store32(&counters->drop_queue_full, 0);
+    AolkmeAtomic_Store32(&counters->drop_isr_queue_full, 0);
+    AolkmeAtomic_Store32(&counters->drop_invalid, 0);
+    AolkmeAtomic_Store32(&counters->drop_block_timeout, 0);
+    AolkmeAtomic_Store32(&counters->drop_oldest, 0);
+    AolkmeAtomic_Store32(&counters->drop_newest, 0);
+    AolkmeAtomic_Store32(&counters->drop_lowest_priority, 0);
+    AolkmeAtomic_Store32(&counters->peak_queue_depth, AolkmeAtomic_Load32(&counters->queue_depth));
+    for (uint8_t i = 0; i < AOLKME_EVENT_LATENCY_BUCKETS; i++) {
+        AolkmeAtomic_Store32(&counters->latency_histogram[i], 0);
+    }
+
+    uint32_t count = AolkmeAtomic_Load32(&g_event_system_context.handler_stats_count);
+    for (uint32_t i = 0; i < count; i++) {
+        T_AolkmeEventHandlerStatsSlot* slot = &g_event_system_context.handler_stats[i];
+        AolkmeAtomic_Store32(&slot->call_count, 0);
+        AolkmeAtomic_Store32(&slot->total_time_us, 0);
+        AolkmeAtomic_Store32(&slot->max_time_us, 0);
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+T_AolkmeReturnCode AolkmeEvent_StatsInit(uint16_t handler_capacity)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    memset(&g_event_system_context.counters, 0, sizeof(g_event_system_context.counters));
+
+    // Only static routes: no runtime handler to track
+    if (handler_capacity == 0) {
+        g_event_system_context.handler_stats = NULL;
+        g_event_system_context.handler_stats_capacity = 0;
+        g_event_system_context.handler_stats_count = 0;
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    }
+
+    g_event_system_context.handler_stats = (T_AolkmeEventHandlerStatsSlot*)osal->Malloc(handler_capacity * sizeof(T_AolkmeEventHandlerStatsSlot));
+    if (g_event_system_context.handler_stats == NULL) {
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+    memset(g_event_system_context.handler_stats, 0, handler_capacity * sizeof(T_AolkmeEventHandlerStatsSlot));
+    g_event_system_context.handler_stats_capacity = handler_capacity;
+    g_event_system_context.handler_stats_count = 0;
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void AolkmeEvent_StatsDeinit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return;
+    }
+
+    if (g_event_system_context.handler_stats != NULL) {
+        osal->Free(g_event_system_context.handler_stats);
+    }
+    g_event_system_context.handler_stats = NULL;
+    g_event_system_context.handler_stats_capacity = 0;
+    g_event_system_context.handler_stats_count = 0;
+}
+
+
+uint16_t AolkmeEvent_StatsHandlerSlot(AolkmeEventRefHandler handler, AolkmeEventHandler value_handler)
+{
+    uint32_t count = g_event_system_context.handler_stats_count;
+
+    for (uint32_t i = 0; i < count; i++) {
+        T_AolkmeEventHandlerStatsSlot* slot = &g_event_system_context.handler_stats[i];
+        if (slot->handler == handler && slot->value_handler == value_handler) {
+            return (uint16_t)i;
+        }
+    }
+
+    if (count >= g_event_system_context.handler_stats_capacity) {
+        return AOLKME_EVENT_STATS_NONE;
+    }
+
+    // Fill the entry before publishing it to GetHandlerStats readers
+    g_event_system_context.handler_stats[count].handler = handler;
+    g_event_system_context.handler_stats[count].value_handler = value_handler;
+    AolkmeAtomic_Store32(&g_event_system_context.handler_stats_count, count + 1);
+
+    return (uint16_t)count;
+}
+
+
+void AolkmeEvent_StatsHandlerTime(uint16_t slot_index, uint32_t time_us)
+{
+    if (slot_index >= g_event_system_context.handler_stats_capacity) {
+        return;
+    }
+
+    T_AolkmeEventHandlerStatsSlot* slot = &g_event_system_context.handler_stats[slot_index];
+    AolkmeAtomic_Add32(&slot->call_count, 1);
+    AolkmeAtomic_Add32(&slot->total_time_us, time_us);
+    event_stats_max(&slot->max_time_us, time_us);
+}
+
+
+void AolkmeEvent_StatsEnqueued(void)
+{
+    T_AolkmeEventCounters* counters = &g_event_system_context.counters;
+    event_stats_max(&counters->peak_queue_depth, AolkmeAtomic_Add32(&counters->queue_depth, 1));
+}
+
+
+void AolkmeEvent_StatsDequeued(uint32_t count)
+{
+    AolkmeAtomic_Add32(&g_event_system_context.counters.queue_depth, (uint32_t)0 - count);
+}
+
+
+void AolkmeEvent_StatsDispatched(uint32_t latency_us)
+{
+    T_AolkmeEventCounters* counters = &g_event_system_context.counters;
+    AolkmeAtomic_Add32(&counters->dispatch_count, 1);
+    AolkmeAtomic_Add32(&counters->latency_histogram[event_stats_bucket(latency_us)], 1);
+}
+
+
+uint32_t AolkmeEvent_StatsTimeUs(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    uint32_t time = 0;
+
+    if (osal && osal->GetTimeUs) {
+        osal->GetTimeUs(&time);
+    } else if (osal) {
+        osal->GetTimeMs(&time);
+        time *= 1000;
+    }
+    return time;
+}
+
+
+
+
+
+
+
+// ================= Helpers ================= //
+
+/**
+ * @brief Histogram bucket: 0 for 0 us, n for [2^(n-1), 2^n) us, the last one is open-ended.
+ */
+static uint8_t event_stats_bucket(uint32_t latency_us)
+{
+    uint8_t bucket = 0;
+
+    while (latency_us != 0 && bucket < AOLKME_EVENT_LATENCY_BUCKETS - 1) {
+        latency_us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+
+static void event_stats_max(volatile uint32_t* max, uint32_t value)
+{
+    uint32_t current = AolkmeAtomic_Load32(max);
+
+    while (value > current && !AolkmeAtomic_CompareExchange32(max, current, value)) {
+        current = AolkmeAtomic_Load32(max);
+    }
+}
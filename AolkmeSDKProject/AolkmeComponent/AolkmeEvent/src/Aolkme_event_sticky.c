@@ -0,0 +1,334 @@
+/**
+ * @file Aolkme_event_sticky.c
+ * @author Aolkme
+ * @brief 粘性事件：缓存指定事件ID最近一次分发的事件，新订阅者立即收到，也可直接查询，无需轮询或重新请求状态
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+static int8_t event_sticky_find(E_AolkmeEventID id);
+static bool event_sticky_listed(E_AolkmeEventID id);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Keep (or stop keeping) the last dispatched event of an ID.
+ *
+ * @param id
+ * @param enable
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_SetSticky(E_AolkmeEventID id, bool enable)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    // Event tasks scan sticky_ids[] without the mutex, as for coalesce_ids[]
+    uint32_t count = g_event_system_context.sticky_id_count;
+    int8_t index = event_sticky_find(id);
+    T_AolkmeEventStickySlot dropped = { .valid = false };
+
+    if (enable && index < 0) {
+        if (count < MAX_EVENT_SYSTEM_STICKY_IDS) {
+            g_event_system_context.sticky_slots[count].valid = false;
+            AolkmeAtomic_Store32(&g_event_system_context.sticky_ids[count], id);
+            AolkmeAtomic_Store32(&g_event_system_context.sticky_id_count, count + 1);
+        } else {
+            returncode = AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+        }
+    } else if (!enable && index >= 0) {
+        dropped = g_event_system_context.sticky_slots[index];
+        g_event_system_context.sticky_slots[index] = g_event_system_context.sticky_slots[count - 1];
+        AolkmeAtomic_Store32(&g_event_system_context.sticky_ids[index], g_event_system_context.sticky_ids[count - 1]);
+        AolkmeAtomic_Store32(&g_event_system_context.sticky_id_count, count - 1);
+    }
+
+    AolkmeEvent_Unlock();
+
+    if (dropped.valid) {
+        AolkmeEvent_FreeData(&dropped.event);
+    }
+
+    return returncode;
+}
+
+
+/**
+ * @brief Copy the last dispatched event of a sticky ID.
+ *
+ * @param id
+ * @param event
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_GetLast(E_AolkmeEventID id, T_AolkmeEvent* event)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (event == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    int8_t index = event_sticky_find(id);
+    if (index < 0) {
+        returncode = AOLKME_ERROR_EVENT_MODULE_CODE_NOT_SUPPORTED;
+    } else if (!g_event_system_context.sticky_slots[index].valid) {
+        returncode = AOLKME_ERROR_EVENT_MODULE_CODE_HANDLER_NOT_FOUND;
+    } else {
+        *event = g_event_system_context.sticky_slots[index].event;
+        if (event->data != NULL && (event->flags & EVENT_FLAG_SHARED_DATA)) {
+            AolkmeEvent_SharedRetain(event->data);
+        }
+    }
+
+    AolkmeEvent_Unlock();
+    return returncode;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+void AolkmeEvent_StickyInit(void)
+{
+    g_event_system_context.sticky_id_count = 0;
+    memset(g_event_system_context.sticky_slots, 0, sizeof(g_event_system_context.sticky_slots));
+    memset(g_event_system_context.sticky_deliveries, 0, sizeof(g_event_system_context.sticky_deliveries));
+    g_event_system_context.sticky_delivery_count = 0;
+}
+
+
+void AolkmeEvent_StickyDeinit(void)
+{
+    for (uint32_t i = 0; i < g_event_system_context.sticky_id_count; i++) {
+        if (g_event_system_context.sticky_slots[i].valid) {
+            AolkmeEvent_FreeData(&g_event_system_context.sticky_slots[i].event);
+        }
+    }
+    AolkmeEvent_StickyInit();
+}
+
+
+bool AolkmeEvent_StickyStore(T_AolkmeEvent* event)
+{
+    if (AolkmeAtomic_Load32(&g_event_system_context.sticky_id_count) == 0 || !event_sticky_listed(event->ID)) {
+        return false;
+    }
+
+    T_AolkmeEvent cached = *event;
+    bool valid = true;
+    cached.reply = 0;
+
+    // A dynamic payload cannot be lent out while the cache may replace it: keep a shared copy
+    if (cached.data != NULL && (cached.flags & EVENT_FLAG_DYNAMIC_DATA)) {
+        cached.data = (cached.data_size > 0) ? AolkmeEvent_SharedAlloc(cached.data_size) : NULL;
+        if (cached.data != NULL) {
+            memcpy(cached.data, event->data, cached.data_size);
+        }
+        cached.flags = (uint8_t)((cached.flags & ~EVENT_FLAG_DYNAMIC_DATA) | EVENT_FLAG_SHARED_DATA);
+        AolkmeEvent_FreeData(event);
+
+        // Out of memory: rather no cached event than one without its payload
+        valid = (cached.data != NULL || cached.data_size == 0);
+    }
+
+    if (AolkmeEvent_Lock() != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_FreeData(&cached);
+        return true;
+    }
+
+    // Swap under the mutex, free the replaced payload outside it
+    T_AolkmeEventStickySlot replaced = { .valid = false };
+    int8_t index = event_sticky_find(cached.ID);
+    if (index >= 0) {
+        replaced = g_event_system_context.sticky_slots[index];
+        g_event_system_context.sticky_slots[index].event = cached;
+        g_event_system_context.sticky_slots[index].valid = valid;
+    } else {
+        // Disabled meanwhile
+        replaced.event = cached;
+        replaced.valid = true;
+    }
+
+    AolkmeEvent_Unlock();
+
+    if (replaced.valid) {
+        AolkmeEvent_FreeData(&replaced.event);
+    }
+    return true;
+}
+
+
+void AolkmeEvent_StickySubscribed(const T_AolkmeEventRoute* route)
+{
+    // Deliveries are made by the event tasks
+    if (!g_event_system_context.task_running) {
+        return;
+    }
+
+    // Workers dispatching a cached event inside the new route's range
+    uint8_t workers = 0;
+    for (uint32_t i = 0; i < g_event_system_context.sticky_id_count; i++) {
+        const T_AolkmeEventStickySlot* slot = &g_event_system_context.sticky_slots[i];
+        if (slot->valid && AolkmeEvent_RouteMatches(route->first, route->last, route->mask, slot->event.ID)) {
+            T_AolkmeEventWorker* worker = AolkmeEvent_QueueWorkerOf(&slot->event);
+            workers |= (uint8_t)(1u << (worker - g_event_system_context.workers));
+        }
+    }
+
+    if (workers == 0) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < MAX_EVENT_SYSTEM_STICKY_IDS; i++) {
+        T_AolkmeEventStickyDelivery* delivery = &g_event_system_context.sticky_deliveries[i];
+        if (delivery->workers != 0) {
+            continue;
+        }
+
+        delivery->first = route->first;
+        delivery->last = route->last;
+        delivery->mask = route->mask;
+        delivery->handler = route->handler;
+        delivery->value_handler = route->value_handler;
+        delivery->workers = workers;
+        AolkmeAtomic_Add32(&g_event_system_context.sticky_delivery_count, 1);
+
+        T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+        for (uint8_t w = 0; osal && w < g_event_system_context.worker_count; w++) {
+            if (workers & (1u << w)) {
+                osal->SemaPost(g_event_system_context.workers[w].event_sem);
+            }
+        }
+        return;
+    }
+
+    // All delivery entries busy (a burst of subscriptions): this subscriber waits for the next event
+}
+
+
+void AolkmeEvent_StickyDeliver(T_AolkmeEventWorker* worker)
+{
+    uint8_t bit = (uint8_t)(1u << (worker - g_event_system_context.workers));
+
+    for (uint8_t d = 0; d < MAX_EVENT_SYSTEM_STICKY_IDS; d++) {
+        T_AolkmeEventStickyDelivery* delivery = &g_event_system_context.sticky_deliveries[d];
+        if (!(delivery->workers & bit)) {
+            continue;
+        }
+
+        // One cached event at a time, handed out with its own payload reference and no lock held,
+        // so the handler may subscribe, publish or query the cache
+        for (uint32_t i = 0; ; i++) {
+            T_AolkmeEvent event = { 0 };
+            AolkmeEventRefHandler handler = NULL;
+            AolkmeEventHandler value_handler = NULL;
+
+            if (AolkmeEvent_Lock() != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+                return;
+            }
+
+            if (i >= g_event_system_context.sticky_id_count) {
+                AolkmeEvent_Unlock();
+                break;
+            }
+
+            const T_AolkmeEventStickySlot* slot = &g_event_system_context.sticky_slots[i];
+            if (slot->valid && AolkmeEvent_RouteMatches(delivery->first, delivery->last, delivery->mask, slot->event.ID) &&
+                AolkmeEvent_QueueWorkerOf(&slot->event) == worker) {
+                event = slot->event;
+                if (event.data != NULL && (event.flags & EVENT_FLAG_SHARED_DATA)) {
+                    AolkmeEvent_SharedRetain(event.data);
+                }
+                handler = delivery->handler;
+                value_handler = delivery->value_handler;
+            }
+
+            AolkmeEvent_Unlock();
+
+            if (handler != NULL) {
+                handler(&event);
+            } else if (value_handler != NULL) {
+                value_handler(event);
+            } else {
+                continue;
+            }
+            AolkmeEvent_FreeData(&event);
+        }
+
+        if (AolkmeEvent_Lock() != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            return;
+        }
+        delivery->workers &= (uint8_t)~bit;
+        if (delivery->workers == 0) {
+            AolkmeAtomic_Add32(&g_event_system_context.sticky_delivery_count, (uint32_t)-1);
+        }
+        AolkmeEvent_Unlock();
+    }
+}
+
+
+
+
+
+
+
+// ================= Helpers ================= //
+
+/**
+ * @brief Index of id in sticky_ids[], -1 if not sticky. Mutex held.
+ */
+static int8_t event_sticky_find(E_AolkmeEventID id)
+{
+    for (uint32_t i = 0; i < g_event_system_context.sticky_id_count; i++) {
+        if (g_event_system_context.sticky_ids[i] == id) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Lock-free check for the dispatch path; confirmed under the mutex by the caller.
+ */
+static bool event_sticky_listed(E_AolkmeEventID id)
+{
+    uint32_t count = AolkmeAtomic_Load32(&g_event_system_context.sticky_id_count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (AolkmeAtomic_Load32(&g_event_system_context.sticky_ids[i]) == id) {
+            return true;
+        }
+    }
+    return false;
+}
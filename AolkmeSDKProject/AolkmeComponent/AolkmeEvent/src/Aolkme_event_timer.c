@@ -0,0 +1,360 @@
+/**
+ * @file Aolkme_event_timer.c
+ * @author Aolkme
+ * @brief 延时/周期事件：最小堆定时器，由第一个事件任务驱动，无需为周期发布单独创建任务
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+#define EVENT_TIMER_HANDLE(generation, slot)    (((uint32_t)(generation) << 8) | (slot))
+#define EVENT_TIMER_SLOT(handle)                ((handle) & 0xFFu)
+#define EVENT_TIMER_GENERATION(handle)          ((uint16_t)((handle) >> 8))
+
+
+
+static T_AolkmeReturnCode event_timer_add(const T_AolkmeEvent* event, uint32_t delay_ms, uint32_t period_ms, T_AolkmeEventTimerHandle* handle);
+static bool event_timer_before(uint8_t a, uint8_t b);
+static void event_timer_swap(uint8_t i, uint8_t j);
+static void event_timer_sift_up(uint8_t index);
+static void event_timer_sift_down(uint8_t index);
+static void event_timer_remove(uint8_t index);
+static void event_timer_wake(void);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Publish an event once, delay_ms from now.
+ *
+ * @param event
+ * @param delay_ms
+ * @param handle Optional, for AolkmeEvent_CancelTimer()
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishDelayed(const T_AolkmeEvent* event, uint32_t delay_ms, T_AolkmeEventTimerHandle* handle)
+{
+    return event_timer_add(event, delay_ms, 0, handle);
+}
+
+
+/**
+ * @brief Publish a copy of event every period_ms, the first one period_ms from now.
+ *
+ * @param event
+ * @param period_ms
+ * @param handle Optional, for AolkmeEvent_CancelTimer()
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_PublishPeriodic(const T_AolkmeEvent* event, uint32_t period_ms, T_AolkmeEventTimerHandle* handle)
+{
+    if (period_ms == 0 || (event != NULL && (event->flags & EVENT_FLAG_DYNAMIC_DATA))) {
+        // A dynamic payload would be freed after the first dispatch
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    return event_timer_add(event, period_ms, period_ms, handle);
+}
+
+
+/**
+ * @brief Stop a delayed or periodic event. The event's payload reference is dropped.
+ *
+ * @param handle
+ * @return T_AolkmeReturnCode HANDLER_NOT_FOUND if the timer already fired (one-shot) or was cancelled
+ */
+T_AolkmeReturnCode AolkmeEvent_CancelTimer(T_AolkmeEventTimerHandle handle)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    uint32_t slot = EVENT_TIMER_SLOT(handle);
+    if (slot >= MAX_EVENT_SYSTEM_TIMERS) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    T_AolkmeEventTimer* timer = &g_event_system_context.timers[slot];
+    T_AolkmeEvent event;
+    bool cancelled = false;
+
+    if (timer->heap_index != AOLKME_EVENT_TIMER_FREE && timer->generation == EVENT_TIMER_GENERATION(handle)) {
+        event = timer->event;
+        event_timer_remove(timer->heap_index);
+        cancelled = true;
+    }
+
+    AolkmeEvent_Unlock();
+
+    if (!cancelled) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_HANDLER_NOT_FOUND;
+    }
+
+    AolkmeEvent_FreeData(&event);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+void AolkmeEvent_TimerInit(void)
+{
+    memset(g_event_system_context.timers, 0, sizeof(g_event_system_context.timers));
+    for (uint8_t i = 0; i < MAX_EVENT_SYSTEM_TIMERS; i++) {
+        g_event_system_context.timers[i].heap_index = AOLKME_EVENT_TIMER_FREE;
+    }
+    g_event_system_context.timer_count = 0;
+}
+
+
+void AolkmeEvent_TimerDeinit(void)
+{
+    while (g_event_system_context.timer_count > 0) {
+        T_AolkmeEvent event = g_event_system_context.timers[g_event_system_context.timer_heap[0]].event;
+        event_timer_remove(0);
+        AolkmeEvent_FreeData(&event);
+    }
+}
+
+
+uint32_t AolkmeEvent_TimerRun(uint32_t max_wait_ms)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return max_wait_ms;
+    }
+
+    for (;;) {
+        // No timer armed: skip the mutex. Arming a timer wakes this task again.
+        if (g_event_system_context.timer_count == 0) {
+            return max_wait_ms;
+        }
+
+        uint32_t now;
+        osal->GetTimeMs(&now);
+
+        if (AolkmeEvent_Lock() != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            return max_wait_ms;
+        }
+
+        if (g_event_system_context.timer_count == 0) {
+            AolkmeEvent_Unlock();
+            return max_wait_ms;
+        }
+
+        uint8_t slot = g_event_system_context.timer_heap[0];
+        T_AolkmeEventTimer* timer = &g_event_system_context.timers[slot];
+        int32_t remaining = (int32_t)(timer->due_ms - now);
+        if (remaining > 0) {
+            AolkmeEvent_Unlock();
+            return ((uint32_t)remaining < max_wait_ms) ? (uint32_t)remaining : max_wait_ms;
+        }
+
+        // Due: re-arm a periodic timer from its due time so it does not drift, retire a one-shot
+        T_AolkmeEvent event = timer->event;
+        if (timer->period_ms != 0) {
+            timer->due_ms += timer->period_ms;
+            if ((int32_t)(timer->due_ms - now) <= 0) {
+                // Fell more than a period behind, skip the missed ones
+                timer->due_ms = now + timer->period_ms;
+            }
+            event_timer_sift_down(0);
+            if (event.flags & EVENT_FLAG_SHARED_DATA) {
+                AolkmeEvent_SharedRetain(event.data);
+            }
+        } else {
+            event_timer_remove(0);
+        }
+
+        AolkmeEvent_Unlock();
+
+        // Publish outside the mutex; a full queue drops this occurrence like any other publish.
+        // This is the event task: a BLOCK policy would wait for itself, drop instead
+        uint32_t timeout_ms = 0;
+        uint8_t policy = AolkmeEvent_BackpressureRule(event.ID, &timeout_ms);
+        if (policy == AOLKME_EVENT_BACKPRESSURE_BLOCK) {
+            policy = AOLKME_EVENT_BACKPRESSURE_DROP_NEWEST;
+        }
+        if (AolkmeEvent_PublishEventPolicy(&event, (E_AolkmeEventBackpressure)policy, timeout_ms) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            AolkmeEvent_FreeData(&event);
+        }
+    }
+}
+
+
+
+
+
+
+
+// ================= Min-heap ================= //
+
+static T_AolkmeReturnCode event_timer_add(const T_AolkmeEvent* event, uint32_t delay_ms, uint32_t period_ms, T_AolkmeEventTimerHandle* handle)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (event == NULL || (event->flags & EVENT_FLAG_RESERVED)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    T_AolkmeReturnCode returncode = AolkmeEvent_Lock();
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    uint8_t slot = 0;
+    while (slot < MAX_EVENT_SYSTEM_TIMERS && g_event_system_context.timers[slot].heap_index != AOLKME_EVENT_TIMER_FREE) {
+        slot++;
+    }
+
+    if (slot == MAX_EVENT_SYSTEM_TIMERS) {
+        AolkmeEvent_Unlock();
+        return AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+    }
+
+    uint32_t now;
+    osal->GetTimeMs(&now);
+
+    T_AolkmeEventTimer* timer = &g_event_system_context.timers[slot];
+    timer->event = *event;
+    timer->due_ms = now + delay_ms;
+    timer->period_ms = period_ms;
+    timer->generation++;
+
+    uint8_t index = g_event_system_context.timer_count++;
+    g_event_system_context.timer_heap[index] = slot;
+    timer->heap_index = index;
+    event_timer_sift_up(index);
+
+    bool earliest = (timer->heap_index == 0);
+    if (handle) {
+        *handle = EVENT_TIMER_HANDLE(timer->generation, slot);
+    }
+
+    AolkmeEvent_Unlock();
+
+    // The timer task may be sleeping towards a later deadline
+    if (earliest) {
+        event_timer_wake();
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+static bool event_timer_before(uint8_t a, uint8_t b)
+{
+    return (int32_t)(g_event_system_context.timers[a].due_ms - g_event_system_context.timers[b].due_ms) < 0;
+}
+
+
+static void event_timer_swap(uint8_t i, uint8_t j)
+{
+    uint8_t* heap = g_event_system_context.timer_heap;
+    uint8_t slot = heap[i];
+
+    heap[i] = heap[j];
+    heap[j] = slot;
+    g_event_system_context.timers[heap[i]].heap_index = i;
+    g_event_system_context.timers[heap[j]].heap_index = j;
+}
+
+
+static void event_timer_sift_up(uint8_t index)
+{
+    uint8_t* heap = g_event_system_context.timer_heap;
+
+    while (index > 0) {
+        uint8_t parent = (uint8_t)((index - 1) / 2);
+        if (!event_timer_before(heap[index], heap[parent])) {
+            break;
+        }
+        event_timer_swap(index, parent);
+        index = parent;
+    }
+}
+
+
+static void event_timer_sift_down(uint8_t index)
+{
+    uint8_t* heap = g_event_system_context.timer_heap;
+    uint8_t count = g_event_system_context.timer_count;
+
+    for (;;) {
+        uint8_t smallest = index;
+        uint8_t left = (uint8_t)(2 * index + 1);
+        uint8_t right = (uint8_t)(2 * index + 2);
+
+        if (left < count && event_timer_before(heap[left], heap[smallest])) {
+            smallest = left;
+        }
+        if (right < count && event_timer_before(heap[right], heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        event_timer_swap(index, smallest);
+        index = smallest;
+    }
+}
+
+
+/**
+ * @brief Take the timer at heap position index out of the heap and free its slot.
+ */
+static void event_timer_remove(uint8_t index)
+{
+    uint8_t* heap = g_event_system_context.timer_heap;
+    uint8_t last = (uint8_t)(--g_event_system_context.timer_count);
+
+    g_event_system_context.timers[heap[index]].heap_index = AOLKME_EVENT_TIMER_FREE;
+
+    if (index != last) {
+        heap[index] = heap[last];
+        g_event_system_context.timers[heap[index]].heap_index = index;
+        event_timer_sift_down(index);
+        event_timer_sift_up(index);
+    }
+}
+
+
+/**
+ * @brief Wake the first worker, which runs the timers.
+ */
+static void event_timer_wake(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+
+    if (osal && g_event_system_context.task_running) {
+        osal->SemaPost(g_event_system_context.workers[0].event_sem);
+    }
+}
@@ -75,6 +75,10 @@ T_AolkmeReturnCode A_Osal_SemaphoreWait(T_AolkmeSemaHandle semaphore);
  * Semaphore_Post
  */
 T_AolkmeReturnCode A_Osal_SemaphorePost(T_AolkmeSemaHandle semaphore);
+/**
+ * Semaphore_Post_From_ISR
+ */
+T_AolkmeReturnCode A_Osal_SemaphorePostFromISR(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken);
 /**
  * Get_TimeMs
  */
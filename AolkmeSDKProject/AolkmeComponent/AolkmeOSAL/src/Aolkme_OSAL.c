@@ -235,6 +235,28 @@ T_AolkmeReturnCode A_Osal_SemaphorePost(T_AolkmeSemaHandle semaphore)
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
+/**
+ * Semaphore_Post_From_ISR
+ */
+T_AolkmeReturnCode A_Osal_SemaphorePostFromISR(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (semaphore == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    if (xSemaphoreGiveFromISR(semaphore, &woken) != pdTRUE) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+
+    if (pxHigherPriorityTaskWoken != NULL) {
+        *pxHigherPriorityTaskWoken = (woken == pdTRUE);
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
 /**
  * Get_TimeMs
  */
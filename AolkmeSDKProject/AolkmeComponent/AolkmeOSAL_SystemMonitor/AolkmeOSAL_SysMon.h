@@ -60,7 +60,7 @@ typedef struct {
     uint32_t taskCount;
 } T_AolkmeSystemResource;
 
-void SystemMonitorEventHandler(T_AolkmeEvent event);
+void SystemMonitorEventHandler(const T_AolkmeEvent* event);
 
 T_AolkmeReturnCode A_Osal_SystemMonitorInit(uint32_t periodMs);
 T_AolkmeReturnCode A_Osal_SystemMonitorStart(void);
@@ -43,8 +43,9 @@ typedef struct {
 
 
 static TaskRegistry_t g_taskRegistry[MAX_TASK_REGISTRY];
-static TaskHandle_t monitorTaskHandle = NULL;
-static uint32_t monitorPeriodTicks = 0;
+static T_AolkmeEventTimerHandle monitorTimer;
+static bool monitorRunning = false;
+static uint32_t monitorPeriodMs = 0;
 
 
 static const char *stateToStr(T_AolkmeTaskState state) {
@@ -153,48 +154,50 @@ static void AolkmeMonitorTask(void *pvParameters)
 
 #else
 /**
- * @brief System Monitor Task - publish system snapshot as event
+ * @brief System Monitor Tick - publish system snapshot as event
+ *
+ * 由事件系统的周期定时事件驱动（AolkmeEvent_PublishPeriodic），不再单独占用一个任务和栈
  */
-static void AolkmeMonitorTask(void *pvParameters)
+static void AolkmeMonitorTick(const T_AolkmeEvent *event)
 {
-    while (1) {
-        T_AolkmeSystemResource res;
-        A_Osal_SystemMonitorGetResource(&res);
-
-        // 计算一次性分配所需大小
-        size_t totalSize = sizeof(T_AolkmeMonitorReport) + res.taskCount * sizeof(T_AolkmeTaskStatus);
-        T_AolkmeMonitorReport *report = pvPortMalloc(totalSize);
-        if (report) {
-            memset(report, 0, totalSize);
-            report->resource = res;
-            report->taskCount = res.taskCount;
-            report->tasks = (T_AolkmeTaskStatus *)(report + 1); // 指向紧随其后的数组
-
-            uint32_t count = res.taskCount;
-            if (A_Osal_SystemMonitorGetTaskList(report->tasks, &count) == 
-                AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) 
-            {
-                // 构造事件
-                T_AolkmeEvent monitorEvent;
-                monitorEvent.ID        = AOLKME_EVENT_SYSTEM_MONITOR_REPORT;
-                monitorEvent.timestamp = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
-                monitorEvent.source    = NULL;
-                monitorEvent.data      = report;
-                monitorEvent.data_size = totalSize;
-                monitorEvent.name      = "SystemMonitorReport";
-                monitorEvent.flags     = EVENT_FLAG_DYNAMIC_DATA;  // 标记需要释放
-
-                // 发布事件
-                if (AolkmeEvent_PublishEvent(&monitorEvent) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
-                    // 发布失败，手动释放
-                    vPortFree(report);
-                }
-            } else {
-                vPortFree(report);
-            }
+    (void)event;
+
+    T_AolkmeSystemResource res;
+    A_Osal_SystemMonitorGetResource(&res);
+
+    // 计算一次性分配所需大小；共享数据优先从事件内存池分配，避免堆碎片。
+    // 报告是粘性事件，缓存直接引用这块数据（tasks 指向其内部，不能被复制）
+    size_t totalSize = sizeof(T_AolkmeMonitorReport) + res.taskCount * sizeof(T_AolkmeTaskStatus);
+    T_AolkmeMonitorReport *report = AolkmeEvent_SharedAlloc(totalSize);
+    if (report) {
+        memset(report, 0, totalSize);
+        report->resource = res;
+        report->taskCount = res.taskCount;
+        report->tasks = (T_AolkmeTaskStatus *)(report + 1); // 指向紧随其后的数组
+
+        uint32_t count = res.taskCount;
+        bool published = false;
+        if (A_Osal_SystemMonitorGetTaskList(report->tasks, &count) == 
+            AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) 
+        {
+            // 构造事件
+            T_AolkmeEvent monitorEvent;
+            monitorEvent.ID        = AOLKME_EVENT_SYSTEM_MONITOR_REPORT;
+            monitorEvent.timestamp = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+            monitorEvent.source    = NULL;
+            monitorEvent.data      = report;
+            monitorEvent.data_size = totalSize;
+            monitorEvent.name      = "SystemMonitorReport";
+            monitorEvent.flags     = EVENT_FLAG_SHARED_DATA;   // 引用计数数据，分发和缓存都释放后自动归还
+
+            // 发布事件
+            published = (AolkmeEvent_PublishEvent(&monitorEvent) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS);
         }
 
-        vTaskDelay(monitorPeriodTicks);
+        // 发布失败，手动释放
+        if (!published) {
+            AolkmeEvent_SharedRelease(report);
+        }
     }
 }
 
@@ -207,10 +210,10 @@ static void AolkmeMonitorTask(void *pvParameters)
 
 
 
-void SystemMonitorEventHandler(T_AolkmeEvent event)
+void SystemMonitorEventHandler(const T_AolkmeEvent* event)
 {
-    if (event.ID == AOLKME_EVENT_SYSTEM_MONITOR_REPORT) {
-        T_AolkmeMonitorReport *report = (T_AolkmeMonitorReport *)event.data;
+    if (event->ID == AOLKME_EVENT_SYSTEM_MONITOR_REPORT) {
+        const T_AolkmeMonitorReport *report = (const T_AolkmeMonitorReport *)event->data;
 
         printf("[SysMon] Heap Free: %u, Min Ever: %u, Task Count: %u\n",
                report->resource.freeHeapBytes,
@@ -239,25 +242,45 @@ void SystemMonitorEventHandler(T_AolkmeEvent event)
 
 T_AolkmeReturnCode A_Osal_SystemMonitorInit(uint32_t periodMs) {
     memset(g_taskRegistry, 0, sizeof(g_taskRegistry));
-    monitorPeriodTicks = pdMS_TO_TICKS(periodMs);
+    monitorPeriodMs = periodMs;
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
 T_AolkmeReturnCode A_Osal_SystemMonitorStart(void) {
-    if (monitorTaskHandle != NULL) {
+    if (monitorRunning) {
         return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
     }
-    if (xTaskCreate(AolkmeMonitorTask, "SysMon", 128, NULL, tskIDLE_PRIORITY + 1, &monitorTaskHandle) != pdPASS) {
-        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+
+    // 保留最近一次报告，之后订阅的任务立即收到，无需等待一个完整周期
+    T_AolkmeReturnCode returncode = AolkmeEvent_SetSticky(AOLKME_EVENT_SYSTEM_MONITOR_REPORT, true);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    returncode = AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_SYSTEM_MONITOR_TICK, AolkmeMonitorTick);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        return returncode;
+    }
+
+    T_AolkmeEvent tick = {
+        .ID   = AOLKME_EVENT_SYSTEM_MONITOR_TICK,
+        .name = "SystemMonitorTick",
+    };
+    returncode = AolkmeEvent_PublishPeriodic(&tick, monitorPeriodMs, &monitorTimer);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeEvent_UnsubscribeEventIdRef(AOLKME_EVENT_SYSTEM_MONITOR_TICK, AolkmeMonitorTick);
+        return returncode;
     }
-    A_Osal_RegisterTaskStackSize(monitorTaskHandle, 128);
+
+    monitorRunning = true;
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
 T_AolkmeReturnCode A_Osal_SystemMonitorStop(void) {
-    if (monitorTaskHandle) {
-        vTaskDelete(monitorTaskHandle);
-        monitorTaskHandle = NULL;
+    if (monitorRunning) {
+        AolkmeEvent_CancelTimer(monitorTimer);
+        AolkmeEvent_UnsubscribeEventIdRef(AOLKME_EVENT_SYSTEM_MONITOR_TICK, AolkmeMonitorTick);
+        monitorRunning = false;
     }
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
@@ -15,6 +15,7 @@
 #include "cmsis_os.h"
 #include "main.h"
 #include "usart.h"
+#include <stdio.h>
 
 
 #include "Aolkme_logger.h"
@@ -28,8 +29,24 @@
 
 
 
+// 日志串口 DMA 双缓冲：一半 DMA 发送时刷新任务填充另一半（须位于 DMA 可访问的 SRAM，不能放 CCM）
+#define USER_CONSOLE_SINK_SIZE      (2 * AOLKME_LOGGER_BATCH_SIZE_DEFAULT)
+#define USER_CONSOLE_SINK_WAIT_MS   100
+// printf 行缓冲：遇到 '\n' 或写满时整行写入日志 sink
+#define USER_CONSOLE_LINE_SIZE      128
+
+
+
 static T_AolkmeReturnCode Aolkme_FillInUserInfo(T_AolkmeUserInfo *userInfo);
 static T_AolkmeReturnCode AolkmeUser_PrintConsole(const uint8_t *data, uint16_t dataLen);
+static T_AolkmeReturnCode AolkmeUser_ConsoleTransmit(const uint8_t *data, uint16_t dataLen);
+
+static T_AolkmeLoggerSink s_consoleSink;
+static uint8_t s_consoleSinkBuffer[USER_CONSOLE_SINK_SIZE];
+static T_AolkmeMutexHandle s_consoleMutex = NULL;          // The sink has a single writer: the flush task and printf take turns
+static volatile bool s_consoleSinkReady = false;            // printf goes through the sink from now on
+static uint8_t s_consoleLine[USER_CONSOLE_LINE_SIZE];       // printf line being assembled, shared by all tasks
+static uint16_t s_consoleLineLen = 0;
 
  T_AolkmeTaskHandle eventgetTaskHandle;
 
@@ -56,6 +73,7 @@ void AolkmeUser_StartTask(void *arg)
         .SemaWait = A_Osal_SemaphoreWait,
 		.SemaTimedWait = A_Osal_SemaphoreTimedWait,
         .SemaPost = A_Osal_SemaphorePost,
+        .SemaPostFromISR = A_Osal_SemaphorePostFromISR,
         .GetTimeMs = A_Osal_GetTimeMs,
         .GetRandomNum = A_Osal_GetRandomNum,
         .Malloc = Osal_Malloc,
@@ -75,12 +93,20 @@ void AolkmeUser_StartTask(void *arg)
         .buffer_size = 30 * AolkmeGetBlockSize(),
     };
 
+	// 事件数据内存池：小块用于普通事件，大块用于系统监控报告
+	static const T_AolkmeEventPoolConfig eventPools[] = {
+        { .block_size = 64,  .block_count = 8 },
+        { .block_size = 512, .block_count = 2 },
+    };
+
 	T_AolkmeEventSystemConfig eventConfig = {
         .queue_size = 64,
         .task_stack_size = 2048,
         .task_priority = 5,
         .max_handlers = 16,
         .enable_auto_processing = true,
+        .pools = eventPools,
+        .pool_count = sizeof(eventPools) / sizeof(eventPools[0]),
     };
 
 	
@@ -119,6 +145,22 @@ void AolkmeUser_StartTask(void *arg)
     }
 	printf("AolkmeLogger_Init is OK!\r\n");
 
+	returnCode = A_Osal_MutexCreate(&s_consoleMutex);
+	if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+    {
+        printf("console mutex create is error\r\n");
+        goto out;
+    }
+
+	returnCode = AolkmeLogger_SinkInit(&s_consoleSink, s_consoleSinkBuffer, sizeof(s_consoleSinkBuffer),
+	                                   AolkmeUser_ConsoleTransmit, USER_CONSOLE_SINK_WAIT_MS);
+	if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+    {
+        printf("AolkmeLogger_SinkInit is error\r\n");
+        goto out;
+    }
+	s_consoleSinkReady = true;
+
 	returnCode = AolkmeLogger_AddOutput(AolkmeUser_PrintConsole);
 	if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
     {
@@ -178,7 +220,7 @@ out:
 void *event_get(void *arg)
 {
 
-	AolkmeEvent_SubscribeEvent(SystemMonitorEventHandler);
+	AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_SYSTEM_MONITOR_REPORT, SystemMonitorEventHandler);
     while (1)
     {
 		osDelay(100);
@@ -219,11 +261,77 @@ static T_AolkmeReturnCode Aolkme_FillInUserInfo(T_AolkmeUserInfo *userInfo)
 
 static T_AolkmeReturnCode AolkmeUser_PrintConsole(const uint8_t *data, uint16_t dataLen)
 {
-    HAL_UART_Transmit(&huart2, (uint8_t *)data, dataLen, AOLKME_OSAL_MAXDELAY);
+    A_Osal_MutexLock(s_consoleMutex);
+    T_AolkmeReturnCode returnCode = AolkmeLogger_SinkWrite(&s_consoleSink, data, dataLen);
+    A_Osal_MutexUnlock(s_consoleMutex);
+    return returnCode;
+}
+
+
+/**
+ * @brief printf output. Once the sink is up, characters are collected in s_consoleLine and each
+ *        line goes to the sink in one write under the mutex, so a blocking send never finds huart2
+ *        busy with a sink DMA transfer (HAL_BUSY would drop the character). Text without a
+ *        trailing '\n' waits for the next line. Before that, from interrupts, and while the
+ *        scheduler is suspended or not started (none of which can block on the mutex), it is
+ *        sent directly.
+ */
+int fputc(int ch, FILE *f)
+{
+    uint8_t c = (uint8_t)ch;
+    uint8_t line[USER_CONSOLE_LINE_SIZE];
+    uint16_t lineLen = 0;
+
+    (void)f;
+    if (!s_consoleSinkReady || __get_IPSR() != 0U || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        HAL_UART_Transmit(&huart2, &c, 1, 0xffff);
+        return ch;
+    }
+
+    // Appending only needs a short critical section; the mutex is taken once per line
+    taskENTER_CRITICAL();
+    s_consoleLine[s_consoleLineLen++] = c;
+    if (c == '\n' || s_consoleLineLen == sizeof(s_consoleLine))
+    {
+        lineLen = s_consoleLineLen;
+        memcpy(line, s_consoleLine, lineLen);
+        s_consoleLineLen = 0;
+    }
+    taskEXIT_CRITICAL();
+
+    if (lineLen != 0U)
+    {
+        A_Osal_MutexLock(s_consoleMutex);
+        AolkmeLogger_SinkWrite(&s_consoleSink, line, lineLen);
+        A_Osal_MutexUnlock(s_consoleMutex);
+    }
+    return ch;
+}
+
+
+static T_AolkmeReturnCode AolkmeUser_ConsoleTransmit(const uint8_t *data, uint16_t dataLen)
+{
+    // All huart2 output goes through the sink; HAL_BUSY is left to a printf from an interrupt
+    if (HAL_UART_Transmit_DMA(&huart2, (uint8_t *)data, dataLen) != HAL_OK)
+    {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
 
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART2)
+    {
+        bool woken;
+        AolkmeLogger_SinkTxComplete(&s_consoleSink, &woken);
+        portYIELD_FROM_ISR(woken ? pdTRUE : pdFALSE);
+    }
+}
+
+
 
 
 
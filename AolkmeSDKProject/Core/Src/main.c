@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "cmsis_os.h"
+#include "dma.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -58,16 +59,7 @@ void MX_FREERTOS_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-int fputc(int ch, FILE *f)
- 
-{
- 
-  HAL_UART_Transmit(&huart2, (uint8_t *)&ch, 1, 0xffff);
- 
-  return ch;
- 
-}
-
+/* fputc (printf) is in App/application.c: it shares huart2 with the console sink */
 
 #define APP_BASE_ADDRESS 0x08010000
 
@@ -102,6 +94,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART1_UART_Init();
   MX_USART2_UART_Init();
   MX_USART3_UART_Init();
@@ -129,6 +129,56 @@ T_AolkmeReturnCode A_Osal_TaskCreate(const char *name, void *(*taskFunc)(void *)
 }
 
 
+/**
+ * Task_Create_Pinned
+ * @brief 创建一个绑定到指定核心的任务
+ * @param name 任务名称
+ * @param taskFunc 任务函数
+ * @param stackSize 任务栈大小
+ * @param arg 任务函数参数
+ * @param core 核心编号（0 或 1）
+ * @param task 任务句柄
+ * @return T_AolkmeReturnCode
+ *
+ */
+T_AolkmeReturnCode A_Osal_TaskCreatePinned(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, int32_t core, T_AolkmeTaskHandle *task)
+{
+    uint32_t stackDepth;
+    char nameDealed[16] = {0};
+
+    if (core < 0 || core >= portNUM_PROCESSORS) {
+        return A_Osal_TaskCreate(name, taskFunc, stackSize, arg, task);
+    }
+
+    // attention: freertos use stack depth param, stack size = (stack depth) * sizeof(StackType_t)
+    if (stackSize % sizeof(StackType_t) == 0) {
+        stackDepth = stackSize / sizeof(StackType_t);
+    } else {
+        stackDepth = stackSize / sizeof(StackType_t) + 1;
+    }
+
+    if (name != NULL)
+        strncpy(nameDealed, name, sizeof(nameDealed) - 1);
+
+    TaskParams *params = pvPortMalloc(sizeof(TaskParams));
+    if (params == NULL) {
+        *task = NULL;
+        return AOLKME_ERROR_OSAL_MODULE_CODE_OUT_OF_MEMORY;
+    }
+
+    params->userFunc = taskFunc;
+    params->userArg = arg;
+
+    if (xTaskCreatePinnedToCore((TaskFunction_t)taskFuncWrapper, nameDealed, stackDepth, params, TASK_PRIORITY_NORMAL, (TaskHandle_t *)task, (BaseType_t)core) != pdPASS) {
+        vPortFree(params);
+        *task = NULL;
+        return AOLKME_ERROR_OSAL_MODULE_CODE_MUTEXCREATE_FAILED;
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
 
 
 
@@ -341,6 +391,28 @@ T_AolkmeReturnCode A_Osal_SemaphorePost(T_AolkmeSemaHandle semaphore)
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
+/**
+ * Semaphore_Post_From_ISR
+ */
+T_AolkmeReturnCode A_Osal_SemaphorePostFromISR(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (semaphore == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    if (xSemaphoreGiveFromISR(semaphore, &woken) != pdTRUE) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+
+    if (pxHigherPriorityTaskWoken != NULL) {
+        *pxHigherPriorityTaskWoken = (woken == pdTRUE);
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
 /**
  * Get_TimeMs
  */
@@ -15,6 +15,10 @@ extern "C" {
  * Task_Create
  */
 T_AolkmeReturnCode A_Osal_TaskCreate(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, T_AolkmeTaskHandle *task);
+/**
+ * Task_Create_Pinned
+ */
+T_AolkmeReturnCode A_Osal_TaskCreatePinned(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, int32_t core, T_AolkmeTaskHandle *task);
 /**
  * Task_Destroy
  */
@@ -63,6 +67,10 @@ T_AolkmeReturnCode A_Osal_SemaphoreWait(T_AolkmeSemaHandle semaphore);
  * Semaphore_Post
  */
 T_AolkmeReturnCode A_Osal_SemaphorePost(T_AolkmeSemaHandle semaphore);
+/**
+ * Semaphore_Post_From_ISR
+ */
+T_AolkmeReturnCode A_Osal_SemaphorePostFromISR(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken);
 /**
  * Get_TimeMs
  */
@@ -163,6 +163,7 @@ typedef enum{
     AOLKME_ERROR_EVENT_MODULE_RAW_CODE_EVENT_QUEUE_FULL = 0x05,
     AOLKME_ERROR_EVENT_MODULE_RAW_CODE_OUT_OF_RESOURCES = 0x06,
     AOLKME_ERROR_EVENT_MODULE_RAW_CODE_HANDLER_NOT_FOUND = 0x07,
+    AOLKME_ERROR_EVENT_MODULE_RAW_CODE_NOT_SUPPORTED = 0x08,
     AOLKME_ERROR_EVENT_MODULE_RAW_CODE_UNKNOWN = 0xFF,
 }E_AolkmeErrorEventModuleRawCode;
 
@@ -236,6 +237,7 @@ enum AolkmeErrorCode{
     AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL = AOLKME_ERROR_CODE(AOLKME_ERROR_MODULE_EVENT, AOLKME_ERROR_EVENT_MODULE_RAW_CODE_EVENT_QUEUE_FULL),
     AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES = AOLKME_ERROR_CODE(AOLKME_ERROR_MODULE_EVENT, AOLKME_ERROR_EVENT_MODULE_RAW_CODE_OUT_OF_RESOURCES),
     AOLKME_ERROR_EVENT_MODULE_CODE_HANDLER_NOT_FOUND = AOLKME_ERROR_CODE(AOLKME_ERROR_MODULE_EVENT, AOLKME_ERROR_EVENT_MODULE_RAW_CODE_HANDLER_NOT_FOUND),
+    AOLKME_ERROR_EVENT_MODULE_CODE_NOT_SUPPORTED = AOLKME_ERROR_CODE(AOLKME_ERROR_MODULE_EVENT, AOLKME_ERROR_EVENT_MODULE_RAW_CODE_NOT_SUPPORTED),
     AOLKME_ERROR_EVENT_MODULE_CODE_UNKNOWN = AOLKME_ERROR_CODE(AOLKME_ERROR_MODULE_EVENT, AOLKME_ERROR_EVENT_MODULE_RAW_CODE_UNKNOWN),
     
 
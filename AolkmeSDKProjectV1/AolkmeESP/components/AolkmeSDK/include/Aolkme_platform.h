@@ -149,6 +149,7 @@ typedef struct
 typedef struct 
 {
     T_AolkmeReturnCode (*TaskCreate)(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, T_AolkmeTaskHandle *task);
+    T_AolkmeReturnCode (*TaskCreatePinned)(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, int32_t core, T_AolkmeTaskHandle *task);   // optional, may be NULL
     T_AolkmeReturnCode (*TaskDestroy)(T_AolkmeTaskHandle task);
     T_AolkmeReturnCode (*TaskSleepMs)(uint32_t timeMs);
     T_AolkmeReturnCode (*MutexCreate)(T_AolkmeMutexHandle *mutex);
@@ -161,7 +162,7 @@ typedef struct
     T_AolkmeReturnCode (*SemaWait)(T_AolkmeSemaHandle semaphore);
     T_AolkmeReturnCode (*SemaTimedWait)(T_AolkmeSemaHandle semaphore, uint32_t waitTimeMs);
     T_AolkmeReturnCode (*SemaPost)(T_AolkmeSemaHandle semaphore);
-//	T_AolkmeReturnCode (*SemaPostFromISR)(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken);
+    T_AolkmeReturnCode (*SemaPostFromISR)(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken);   // optional, may be NULL
     T_AolkmeReturnCode (*GetTimeMs)(uint32_t *ms);
     T_AolkmeReturnCode (*GetTimeUs)(uint32_t *us);
     T_AolkmeReturnCode (*GetRandomNum)(uint16_t *randomNum);
@@ -0,0 +1,217 @@
+/**
+ * @file Aolkme_event_reply.c
+ * @author Aolkme
+ * @brief 请求/应答事件：发布带应答槽的事件并等待处理函数应答，应答槽及其信号量在初始化时创建，请求不分配内存
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+
+#include "Aolkme_event_private.h"
+
+
+
+#define EVENT_REPLY_GENERATION(word)    ((word) & ~0xFFu)       // generation << 8, same bits in state and handle
+#define EVENT_REPLY_STATE(word)         ((word) & 0xFFu)
+#define EVENT_REPLY_SLOT(handle)        ((handle) & 0xFFu)
+
+
+
+static T_AolkmeEventReplySlot* event_reply_claim(uint32_t* handle);
+
+
+
+
+
+
+
+// ================= Public API ================= //
+
+/**
+ * @brief Publish a request and wait for its reply.
+ *
+ * @param event
+ * @param response
+ * @param response_size
+ * @param timeout_ms
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_Request(T_AolkmeEvent* event, void* response, size_t* response_size, uint32_t timeout_ms)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    size_t capacity = (response_size != NULL) ? *response_size : 0;
+    if (event == NULL || (response == NULL && capacity != 0)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    uint32_t handle;
+    T_AolkmeEventReplySlot* slot = event_reply_claim(&handle);
+    if (slot == NULL) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES;
+    }
+
+    uint32_t generation = EVENT_REPLY_GENERATION(handle);
+    slot->buffer = response;
+    slot->capacity = capacity;
+    slot->size = 0;
+
+    event->reply = handle;
+    T_AolkmeReturnCode returncode = AolkmeEvent_PublishEvent(event);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        event->reply = 0;
+        AolkmeAtomic_Store32(&slot->state, generation | AOLKME_EVENT_REPLY_FREE);
+        return returncode;
+    }
+
+    returncode = osal->SemaTimedWait(slot->sem, timeout_ms);
+    if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        // Give up, unless a responder got the slot first: then its post is on the way
+        if (AolkmeAtomic_CompareExchange32(&slot->state, generation | AOLKME_EVENT_REPLY_PENDING,
+                                           generation | AOLKME_EVENT_REPLY_FREE)) {
+            event->reply = 0;
+            return AOLKME_ERROR_SYSTEM_MODULE_CODE_TIMEOUT;
+        }
+        osal->SemaWait(slot->sem);
+    }
+
+    size_t size = slot->size;
+    AolkmeAtomic_Store32(&slot->state, generation | AOLKME_EVENT_REPLY_FREE);
+    event->reply = 0;
+
+    if (response_size != NULL) {
+        *response_size = size;
+    }
+
+    return (size > capacity) ? AOLKME_ERROR_EVENT_MODULE_CODE_OUT_OF_RESOURCES : AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Answer a request. The first reply wins.
+ *
+ * @param request
+ * @param data
+ * @param size
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeEvent_Reply(const T_AolkmeEvent* request, const void* data, size_t size)
+{
+    if (!g_event_system_context.initialized) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    if (request == NULL || request->reply == 0 || EVENT_REPLY_SLOT(request->reply) >= MAX_EVENT_SYSTEM_REPLY_SLOTS ||
+        (data == NULL && size != 0)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeEventReplySlot* slot = &g_event_system_context.replies[EVENT_REPLY_SLOT(request->reply)];
+    uint32_t generation = EVENT_REPLY_GENERATION(request->reply);
+
+    // Only a still pending request of this generation can be answered
+    if (!AolkmeAtomic_CompareExchange32(&slot->state, generation | AOLKME_EVENT_REPLY_PENDING,
+                                        generation | AOLKME_EVENT_REPLY_WRITING)) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_HANDLER_NOT_FOUND;
+    }
+
+    if (size > 0) {
+        memcpy(slot->buffer, data, (size < slot->capacity) ? size : slot->capacity);
+    }
+    slot->size = size;
+
+    AolkmeAtomic_Store32(&slot->state, generation | AOLKME_EVENT_REPLY_DONE);
+    osal->SemaPost(slot->sem);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+
+
+
+
+// ================= Internal API ================= //
+
+T_AolkmeReturnCode AolkmeEvent_ReplyInit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+    if (!osal) {
+        return AOLKME_ERROR_EVENT_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    }
+
+    memset(g_event_system_context.replies, 0, sizeof(g_event_system_context.replies));
+
+    for (uint8_t i = 0; i < MAX_EVENT_SYSTEM_REPLY_SLOTS; i++) {
+        T_AolkmeReturnCode returncode = osal->SemaCreate(0, &g_event_system_context.replies[i].sem);
+        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            AolkmeEvent_ReplyDeinit();
+            return returncode;
+        }
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void AolkmeEvent_ReplyDeinit(void)
+{
+    T_AolkmeOSALHandler *osal = AolkmePlatform_GetOSALHandle();
+
+    for (uint8_t i = 0; i < MAX_EVENT_SYSTEM_REPLY_SLOTS; i++) {
+        if (osal && g_event_system_context.replies[i].sem != NULL) {
+            osal->SemaDestroy(g_event_system_context.replies[i].sem);
+        }
+        g_event_system_context.replies[i].sem = NULL;
+    }
+}
+
+
+
+
+
+
+
+// ================= Helpers ================= //
+
+/**
+ * @brief Take a free reply slot with a new generation (never 0, so a handle is never 0).
+ */
+static T_AolkmeEventReplySlot* event_reply_claim(uint32_t* handle)
+{
+    for (uint8_t i = 0; i < MAX_EVENT_SYSTEM_REPLY_SLOTS; i++) {
+        T_AolkmeEventReplySlot* slot = &g_event_system_context.replies[i];
+        uint32_t state = AolkmeAtomic_Load32(&slot->state);
+
+        if (EVENT_REPLY_STATE(state) != AOLKME_EVENT_REPLY_FREE) {
+            continue;
+        }
+
+        uint32_t generation = EVENT_REPLY_GENERATION(state) + 0x100u;
+        if (generation == 0) {
+            generation = 0x100u;
+        }
+
+        if (AolkmeAtomic_CompareExchange32(&slot->state, state, generation | AOLKME_EVENT_REPLY_PENDING)) {
+            *handle = generation | i;
+            return slot;
+        }
+    }
+
+    return NULL;
+}
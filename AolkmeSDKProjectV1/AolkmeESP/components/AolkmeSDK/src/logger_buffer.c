@@ -1,20 +1,58 @@
-
 #define AOLKME_CORE_IMPLEMENTATION
 
 #include "logger_buffer.h"
 #include "logger_core.h"
 
-#include "Aolkme_Core_Private.h"
+#include "Aolkme_core_private.h"
+#include "Aolkme_atomic.h"
 
-#define LOGGER_BUFFER_BLOCK_SIZE 256
+#define LOGGER_RECORD_COMMITTED     0x80000000u                         // Written, the flush task may output it
+#define LOGGER_RECORD_PAD           0x40000000u                         // Unused tail of the ring, skipped
+#define LOGGER_RECORD_LENGTH(h)     ((h) & 0xFFFFu)
+#define LOGGER_RECORD_LEVEL(h)      (((h) >> 16) & 0xFFu)
+#define LOGGER_RECORD_SIZE(len)     ((uint32_t)(sizeof(T_AolkmeLoggerRecord) + (((len) + 3u) & ~3u)))
+#define LOGGER_BUFFER_DATA_SIZE     (LOGGER_BUFFER_RECORD_MAX - sizeof(T_AolkmeLoggerRecord))
+#define LOGGER_BUFFER_IDLE_WAIT_MS  100                                 // Flush task idle wait, woken earlier by new records
 
 
 
-static T_AolkmeQueueHandle s_AolkmeLoggerBlockQueue = NULL;
-static T_AolkmeMutexHandle s_AolkmeLoggerMutex = NULL;
 static T_AolkmeTaskHandle  s_AolkmeLoggerFlushTask = NULL;
 static bool b_flush_task_running = false;
 
+// Record ring. s_head and s_tail run over [0, 2 * s_ring_size) so that a full ring (distance
+// s_ring_size) differs from an empty one (distance 0) without a power of two size.
+// Free bytes are always zero: a record header reads 0 until its producer commits it.
+static uint8_t *s_AolkmeLoggerRing = NULL;
+static uint32_t s_ring_size = 0;
+static volatile uint32_t s_head = 0;                                   // Next reservation, producers
+static volatile uint32_t s_tail = 0;                                   // Oldest record, flush task
+static volatile uint32_t s_ring_peak = 0;
+
+// Output chunk: consecutive records copied together, one output call per chunk
+static uint8_t *s_AolkmeLoggerBatch = NULL;
+static uint16_t s_batch_size = 0;
+
+// Flush task idle: the first producer to commit after it clears the flag and posts the semaphore
+static T_AolkmeSemaHandle s_AolkmeLoggerDataSema = NULL;
+static volatile uint32_t s_flush_idle = 0;
+
+// AOLKME_LOGGER_OVERFLOW_WAIT: producers waiting for room, woken by the flush task
+static T_AolkmeSemaHandle s_AolkmeLoggerFreeSema = NULL;
+static volatile uint32_t s_free_waiters = 0;
+static E_AolkmeLoggerOverflow s_overflow = AOLKME_LOGGER_OVERFLOW_DROP;
+static uint32_t s_overflow_wait_ms = 0;
+
+
+
+static uint32_t AolkmeLogger_BufferUsed(uint32_t head, uint32_t tail);
+static uint32_t AolkmeLogger_BufferAdvance(uint32_t pos, uint32_t bytes);
+static T_AolkmeLoggerRecord *AolkmeLogger_BufferReserve(uint32_t size);
+static T_AolkmeLoggerRecord *AolkmeLogger_BufferReserveWait(uint32_t size);
+static T_AolkmeLoggerRecord *AolkmeLogger_BufferAt(uint32_t pos);
+static bool AolkmeLogger_BufferReady(void);
+static bool AolkmeLogger_BufferBatch(void);
+static uint16_t AolkmeLogger_BufferGather(uint32_t end, E_AolkmeLoggerConsoleLogLevel min_level);
+
 /**
  * @brief Logger buffer flush task
  * 
@@ -22,7 +60,6 @@ static bool b_flush_task_running = false;
  */
 static void *AolkmeLogger_BufferFlushTask(void *arg)
 {
-    T_AolkmeReturnCode returncode;
     T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
     if (osal_handler == NULL) {
         printf("AolkmePlatform_GetOSALHandle is error\r\n");
@@ -31,30 +68,19 @@ static void *AolkmeLogger_BufferFlushTask(void *arg)
 
     while(b_flush_task_running)
     {
-        T_AolkmeLoggerBlock *block = NULL;
-
-        returncode = osal_handler->QueueReceive(s_AolkmeLoggerBlockQueue, &block, AOLKME_OSAL_MAXDELAY);
-        if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+        if (AolkmeLogger_BufferBatch())
         {
-            printf("Get receive s_AolkmeLoggerBlockQueue is error!\r\n");
+            continue;
         }
-        else
+
+        // Nothing committed: sleep until a producer commits. Checked again after raising the
+        // flag, so a record committed before a producer could see it is not left waiting.
+        AolkmeAtomic_Store32(&s_flush_idle, 1);
+        if (!AolkmeLogger_BufferReady())
         {
-            if (AolkmeCore_GetState() == AOLKME_CORE_STATE_RUNNING)
-            {
-                // Send to output
-                for (uint8_t i = 0; i < g_aolkme_logger_state.output_count; i ++)
-                {
-                    if (block->level <= g_aolkme_logger_state.outputs[i].min_level)
-                    {
-                        g_aolkme_logger_state.outputs[i].func(block->data, block->length);
-                    }
-                }
-            }
-            // printf("[Flush] Freeing block at 0x%p\n", block);
-            osal_handler->Free(block);
+            osal_handler->SemaTimedWait(s_AolkmeLoggerDataSema, LOGGER_BUFFER_IDLE_WAIT_MS);
         }
-        osal_handler->TaskSleepMs(10);
+        AolkmeAtomic_Store32(&s_flush_idle, 0);
     }
 	return NULL;
 }
@@ -63,10 +89,10 @@ static void *AolkmeLogger_BufferFlushTask(void *arg)
 /**
  * @brief Initialize the logger buffer.
  * 
- * @param size The size of the buffer.
+ * @param config buffer_size bytes of ring are allocated here, once.
  * @return T_AolkmeReturnCode 
  */
-T_AolkmeReturnCode AolkmeLogger_BufferInit(size_t size)
+T_AolkmeReturnCode AolkmeLogger_BufferInit(const T_AolkmeLoggerConfig *config)
 {
     
     T_AolkmeReturnCode returncode;
@@ -77,39 +103,91 @@ T_AolkmeReturnCode AolkmeLogger_BufferInit(size_t size)
         return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
     }
 
-    // create mutex
-    returncode = osal_handler->MutexCreate(&s_AolkmeLoggerMutex);
+    // Records are word aligned; two of the largest always fit, whatever the wrap position
+    uint32_t ring_size = config->buffer_size & ~3u;
+    if (ring_size < 2 * LOGGER_BUFFER_RECORD_MAX)
+    {
+        printf("AolkmeLogger buffer_size is too small!\r\n");
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_CONFIG;
+    }
+
+    // create record ring
+    s_AolkmeLoggerRing = osal_handler->Malloc(ring_size);
+    if (s_AolkmeLoggerRing == NULL)
+    {
+        printf("s_AolkmeLoggerRing create is error!\r\n");
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_NO_RESOURCE;
+    }
+    memset(s_AolkmeLoggerRing, 0, ring_size);
+    s_ring_size = ring_size;
+    s_head = 0;
+    s_tail = 0;
+    s_ring_peak = 0;
+    s_free_waiters = 0;
+    s_overflow = config->overflow;
+    s_overflow_wait_ms = config->overflow_wait_ms;
+    s_flush_idle = 0;
+
+    // create output chunk, at least one record long
+    s_batch_size = (config->batch_size != 0) ? config->batch_size : AOLKME_LOGGER_BATCH_SIZE_DEFAULT;
+    if (s_batch_size < LOGGER_BUFFER_DATA_SIZE)
+    {
+        s_batch_size = LOGGER_BUFFER_DATA_SIZE;
+    }
+    s_AolkmeLoggerBatch = osal_handler->Malloc(s_batch_size);
+    if (s_AolkmeLoggerBatch == NULL)
+    {
+        osal_handler->Free(s_AolkmeLoggerRing);
+        s_AolkmeLoggerRing = NULL;
+        printf("s_AolkmeLoggerBatch create is error!\r\n");
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_NO_RESOURCE;
+    }
+
+    // create free space semaphore
+    returncode = osal_handler->SemaCreate(0, &s_AolkmeLoggerFreeSema);
     if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
     {
-        printf("s_AolkmeLoggerMutex create is error!\r\n");
+        osal_handler->Free(s_AolkmeLoggerBatch);
+        s_AolkmeLoggerBatch = NULL;
+        osal_handler->Free(s_AolkmeLoggerRing);
+        s_AolkmeLoggerRing = NULL;
+        printf("s_AolkmeLoggerFreeSema create is error!\r\n");
         return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
     }
 
-    // create queue
-    returncode = osal_handler->QueueCreate(size / sizeof(T_AolkmeLoggerBlock*), sizeof(T_AolkmeLoggerBlock*), &s_AolkmeLoggerBlockQueue);
+    // create new data semaphore
+    returncode = osal_handler->SemaCreate(0, &s_AolkmeLoggerDataSema);
     if (returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
     {
-        osal_handler->MutexDestroy(s_AolkmeLoggerMutex);
-        printf("s_AolkmeLoggerBlockQueue create is error!\r\n");
+        osal_handler->SemaDestroy(s_AolkmeLoggerFreeSema);
+        osal_handler->Free(s_AolkmeLoggerBatch);
+        s_AolkmeLoggerBatch = NULL;
+        osal_handler->Free(s_AolkmeLoggerRing);
+        s_AolkmeLoggerRing = NULL;
+        printf("s_AolkmeLoggerDataSema create is error!\r\n");
         return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
     }
 
+    // The flush task checks the flag before its first read
+    b_flush_task_running = true;
+
     // create flush task
     returncode = osal_handler->TaskCreate("Aolkmeloggerflushtask", AolkmeLogger_BufferFlushTask, 2048, NULL, &s_AolkmeLoggerFlushTask);
     if(returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
     {
-        // delete mutex
-        returncode = osal_handler->MutexDestroy(s_AolkmeLoggerMutex);
-        // delete queue
-        returncode = osal_handler->QueueDestroy(s_AolkmeLoggerBlockQueue);
+        b_flush_task_running = false;
+
+        osal_handler->SemaDestroy(s_AolkmeLoggerDataSema);
+        osal_handler->SemaDestroy(s_AolkmeLoggerFreeSema);
+        osal_handler->Free(s_AolkmeLoggerBatch);
+        s_AolkmeLoggerBatch = NULL;
+        osal_handler->Free(s_AolkmeLoggerRing);
+        s_AolkmeLoggerRing = NULL;
 
         printf("Aolkmeloggerflushtask create is error!\r\n");
         return returncode;
     }
 
-    // buffer is enabled
-    b_flush_task_running = true;
-
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
@@ -117,7 +195,10 @@ T_AolkmeReturnCode AolkmeLogger_BufferInit(size_t size)
 
 
 /**
- * @brief Buffer processing
+ * @brief Buffer processing: copy the log into a reserved record and commit it.
+ * 
+ * No mutex with the default drop policy, so any task may log. The only OSAL call is the
+ * non-blocking semaphore post that wakes an idle flush task.
  * 
  * @param data 
  * @param datalen 
@@ -125,55 +206,48 @@ T_AolkmeReturnCode AolkmeLogger_BufferInit(size_t size)
  */
 T_AolkmeReturnCode AolkmeLogger_BufferPut(E_AolkmeLoggerConsoleLogLevel level, uint8_t *data, uint16_t datalen)
 {
-    T_AolkmeReturnCode returnCode;
-    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
-    if (osal_handler == NULL) {
-        printf("AolkmePlatform_GetOSALHandle is error\r\n");
-        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
-    }
-
-    returnCode = osal_handler->MutexLock(s_AolkmeLoggerMutex);
-    if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+    if (s_AolkmeLoggerRing == NULL)
     {
-        printf("Mutex lock failed!\r\n");
-        g_aolkme_logger_state.unlog_count++;
-        return returnCode;
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INITIALIZATION_NOT_DONE;
     }
 
-    // printf("[Buffer] Allocating %d bytes for log block\n", sizeof(T_AolkmeLoggerBlock) + datalen);
+    // Too long for one record: keep the head of the line and its line end
+    bool truncated = (datalen > LOGGER_BUFFER_DATA_SIZE);
+    uint16_t length = truncated ? (uint16_t)LOGGER_BUFFER_DATA_SIZE : datalen;
 
-    // Allocate log block
-    size_t total_size = sizeof(T_AolkmeLoggerBlock) + datalen;
-    if (total_size > LOGGER_BUFFER_BLOCK_SIZE) {
-        g_aolkme_logger_state.unlog_count++;
-        returnCode = AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+    T_AolkmeLoggerRecord *record = AolkmeLogger_BufferReserve(LOGGER_RECORD_SIZE(length));
+    if (record == NULL && s_overflow == AOLKME_LOGGER_OVERFLOW_WAIT)
+    {
+        record = AolkmeLogger_BufferReserveWait(LOGGER_RECORD_SIZE(length));
     }
-
-    T_AolkmeLoggerBlock *block = osal_handler->Malloc(total_size);
-    if (block == NULL)
+    if (record == NULL)
     {
-        printf("[Buffer] Memory allocation failed!\n");
-        g_aolkme_logger_state.unlog_count++;
-        returnCode = AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_REQUEST_PARAMETER;
+        AolkmeAtomic_Add32(&g_aolkme_logger_state.drop_buffer_full, 1);
+        AolkmeAtomic_Add32(&g_aolkme_logger_state.unlog_count, 1);
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_NO_RESOURCE;
     }
 
-    // Initialize log block
-    block->level = level;
-    block->length = datalen;
-    memcpy(block->data, data, datalen);
-
-    // Add to queue
-    returnCode = osal_handler->QueueSend(s_AolkmeLoggerBlockQueue, &block, AOLKME_OSAL_MAXDELAY);
-    if(returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+    if (truncated)
+    {
+        AolkmeAtomic_Add32(&g_aolkme_logger_state.truncated_count, 1);
+        memcpy(record->data, data, length - 2);
+        record->data[length - 2] = '\r';
+        record->data[length - 1] = '\n';
+    }
+    else
     {
-        osal_handler->Free(block);
-        g_aolkme_logger_state.unlog_count++;
-        returnCode = AOLKME_ERROR_SYSTEM_MODULE_CODE_QUEUE_EMPTY;
+        memcpy(record->data, data, length);
     }
 
-    osal_handler->MutexUnlock(s_AolkmeLoggerMutex);
-    return returnCode;
+    // Publish: the data is visible to the flush task before the header is
+    AolkmeAtomic_Store32(&record->header, LOGGER_RECORD_COMMITTED | ((uint32_t)level << 16) | length);
 
+    if (AolkmeAtomic_Load32(&s_flush_idle) != 0 && AolkmeAtomic_CompareExchange32(&s_flush_idle, 1, 0))
+    {
+        T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+        osal_handler->SemaPost(s_AolkmeLoggerDataSema);
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
 /**
@@ -183,7 +257,7 @@ T_AolkmeReturnCode AolkmeLogger_BufferPut(E_AolkmeLoggerConsoleLogLevel level, u
  */
 T_AolkmeReturnCode AolkmeLogger_BufferFlush(void)
 {
-    if(s_AolkmeLoggerBlockQueue == NULL)
+    if(s_AolkmeLoggerRing == NULL)
     {
         return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
     }
@@ -194,25 +268,12 @@ T_AolkmeReturnCode AolkmeLogger_BufferFlush(void)
         return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
     }
 
-    // 等待队列为空
-    uint32_t count;
-    osal_handler->QueueMessageCount(s_AolkmeLoggerBlockQueue, &count);
-    while (count)
+    // 等待环形缓冲为空
+    while (b_flush_task_running && AolkmeAtomic_Load32(&s_tail) != AolkmeAtomic_Load32(&s_head))
     {
-        osal_handler->QueueMessageCount(s_AolkmeLoggerBlockQueue, &count);
         osal_handler->TaskSleepMs(10);
     }
 
-
-    if (s_AolkmeLoggerBlockQueue != NULL)
-    {
-        // Flush remaining logs
-        while (osal_handler->QueueMessageCount(s_AolkmeLoggerBlockQueue, &count) > 0)
-        {
-            osal_handler->TaskSleepMs(10);
-        }
-    }
-
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
@@ -225,7 +286,7 @@ T_AolkmeReturnCode AolkmeLogger_BufferFlush(void)
  */
 T_AolkmeReturnCode AolkmeLogger_BufferDeinit(void)
 {
-    b_flush_task_running = false;
+    // Drained: the flush task is idle between reads and holds nothing when destroyed
     AolkmeLogger_BufferFlush();
 
     T_AolkmeReturnCode returncode;
@@ -245,36 +306,295 @@ T_AolkmeReturnCode AolkmeLogger_BufferDeinit(void)
         }
         s_AolkmeLoggerFlushTask = NULL;
     }
+    b_flush_task_running = false;
 
-    // destroy queue
-    if (s_AolkmeLoggerBlockQueue != NULL)
+    // destroy semaphores
+    if (s_AolkmeLoggerDataSema != NULL)
     {
-        returncode = osal_handler->QueueDestroy(s_AolkmeLoggerBlockQueue);
-        if(returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+        osal_handler->SemaDestroy(s_AolkmeLoggerDataSema);
+        s_AolkmeLoggerDataSema = NULL;
+    }
+    if (s_AolkmeLoggerFreeSema != NULL)
+    {
+        osal_handler->SemaDestroy(s_AolkmeLoggerFreeSema);
+        s_AolkmeLoggerFreeSema = NULL;
+    }
+    // release output chunk
+    if (s_AolkmeLoggerBatch != NULL)
+    {
+        osal_handler->Free(s_AolkmeLoggerBatch);
+        s_AolkmeLoggerBatch = NULL;
+        s_batch_size = 0;
+    }
+    // release record ring
+    if (s_AolkmeLoggerRing != NULL)
+    {
+        osal_handler->Free(s_AolkmeLoggerRing);
+        s_AolkmeLoggerRing = NULL;
+        s_ring_size = 0;
+        s_head = 0;
+        s_tail = 0;
+    }
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+/**
+ * @brief Fill the ring usage fields of stats.
+ * 
+ * @param stats 
+ */
+void AolkmeLogger_BufferStats(T_AolkmeLoggerStats *stats)
+{
+    stats->buffer_size = (uint16_t)s_ring_size;
+    stats->buffer_used = (uint16_t)AolkmeLogger_BufferUsed(AolkmeAtomic_Load32(&s_head), AolkmeAtomic_Load32(&s_tail));
+    stats->buffer_peak = (uint16_t)AolkmeAtomic_Load32(&s_ring_peak);
+}
+
+
+
+size_t AolkmeGetBlockSize(void)
+{
+    return LOGGER_BUFFER_RECORD_MAX;
+}
+
+
+
+/**
+ * @brief Bytes between the flush task and the producers: reserved, committed or being output.
+ */
+static uint32_t AolkmeLogger_BufferUsed(uint32_t head, uint32_t tail)
+{
+    return (head >= tail) ? head - tail : head + 2 * s_ring_size - tail;
+}
+
+
+static uint32_t AolkmeLogger_BufferAdvance(uint32_t pos, uint32_t bytes)
+{
+    pos += bytes;
+    return (pos >= 2 * s_ring_size) ? pos - 2 * s_ring_size : pos;
+}
+
+
+/**
+ * @brief Reserve one contiguous record of size bytes, NULL if the ring is full.
+ * 
+ * A record never wraps: when it does not fit before the end of the ring, the rest of the ring
+ * is reserved with it as a committed pad record and the record starts at offset 0.
+ */
+static T_AolkmeLoggerRecord *AolkmeLogger_BufferReserve(uint32_t size)
+{
+    for (;;)
+    {
+        // Tail first: it never passes the head read after it, so a stale tail can only make
+        // the ring look fuller than it is, never wrap the distance
+        uint32_t tail = AolkmeAtomic_Load32(&s_tail);
+        uint32_t head = AolkmeAtomic_Load32(&s_head);
+        uint32_t offset = (head >= s_ring_size) ? head - s_ring_size : head;
+        uint32_t pad = (offset + size > s_ring_size) ? s_ring_size - offset : 0;
+        uint32_t used = AolkmeLogger_BufferUsed(head, tail) + pad + size;
+        if (used > s_ring_size)
         {
-            return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+            // Full as of these reads; look again if the flush task or a producer moved meanwhile
+            if (AolkmeAtomic_Load32(&s_tail) != tail || AolkmeAtomic_Load32(&s_head) != head)
+            {
+                continue;
+            }
+            return NULL;
+        }
+
+        if (AolkmeAtomic_CompareExchange32(&s_head, head, AolkmeLogger_BufferAdvance(head, pad + size)))
+        {
+            uint32_t peak = AolkmeAtomic_Load32(&s_ring_peak);
+            while (used > peak && !AolkmeAtomic_CompareExchange32(&s_ring_peak, peak, used))
+            {
+                peak = AolkmeAtomic_Load32(&s_ring_peak);
+            }
+
+            if (pad != 0)
+            {
+                T_AolkmeLoggerRecord *skip = (T_AolkmeLoggerRecord *)(s_AolkmeLoggerRing + offset);
+                AolkmeAtomic_Store32(&skip->header, LOGGER_RECORD_COMMITTED | LOGGER_RECORD_PAD | pad);
+                offset = 0;
+            }
+            return (T_AolkmeLoggerRecord *)(s_AolkmeLoggerRing + offset);
         }
-        s_AolkmeLoggerBlockQueue = NULL;
     }
-    // destroy mutex
-    if (s_AolkmeLoggerMutex != NULL)
+}
+
+
+/**
+ * @brief Wait up to s_overflow_wait_ms for the flush task to free room.
+ * 
+ * The producer counts itself in s_free_waiters before retrying, so room freed between a
+ * failed reserve and the wait has already posted the semaphore. Stale posts only cause a retry.
+ */
+static T_AolkmeLoggerRecord *AolkmeLogger_BufferReserveWait(uint32_t size)
+{
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    T_AolkmeLoggerRecord *record = NULL;
+    uint32_t start_ms;
+    uint32_t now_ms;
+
+    osal_handler->GetTimeMs(&start_ms);
+    AolkmeAtomic_Add32(&s_free_waiters, 1);
+
+    for (;;)
     {
-        returncode = osal_handler->MutexDestroy(s_AolkmeLoggerMutex);
-        if(returncode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+        record = AolkmeLogger_BufferReserve(size);
+        if (record != NULL)
         {
-            return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+            break;
+        }
+
+        osal_handler->GetTimeMs(&now_ms);
+        if (now_ms - start_ms >= s_overflow_wait_ms)
+        {
+            break;
         }
-        s_AolkmeLoggerMutex = NULL;
+        osal_handler->SemaTimedWait(s_AolkmeLoggerFreeSema, s_overflow_wait_ms - (now_ms - start_ms));
     }
 
-    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    AolkmeAtomic_Add32(&s_free_waiters, (uint32_t)-1);
+    return record;
 }
 
 
+/**
+ * @brief Record at a ring position.
+ */
+static T_AolkmeLoggerRecord *AolkmeLogger_BufferAt(uint32_t pos)
+{
+    return (T_AolkmeLoggerRecord *)(s_AolkmeLoggerRing + ((pos >= s_ring_size) ? pos - s_ring_size : pos));
+}
 
-size_t AolkmeGetBlockSize(void)
+
+/**
+ * @brief true if the oldest record is committed. Flush task only.
+ */
+static bool AolkmeLogger_BufferReady(void)
 {
-    return sizeof(T_AolkmeLoggerBlock);
+    uint32_t tail = s_tail;
+    return tail != AolkmeAtomic_Load32(&s_head) &&
+           (AolkmeAtomic_Load32(&AolkmeLogger_BufferAt(tail)->header) & LOGGER_RECORD_COMMITTED);
+}
+
+
+/**
+ * @brief Output the committed records at the tail as one chunk per output and release them.
+ *        Flush task only.
+ * 
+ * Records are taken in reservation order, until the first one not committed yet or until the
+ * chunk is full: a producer preempted between reserve and commit holds back the records
+ * reserved after it, never the producers.
+ * 
+ * @return false if the ring is empty or its oldest record is not committed yet.
+ */
+static bool AolkmeLogger_BufferBatch(void)
+{
+    uint32_t tail = s_tail;
+    uint32_t head = AolkmeAtomic_Load32(&s_head);
+    uint32_t end = tail;
+    uint32_t length = 0;
+
+    // Committed records that fit in one chunk; pad records only move end
+    while (end != head)
+    {
+        uint32_t header = AolkmeAtomic_Load32(&AolkmeLogger_BufferAt(end)->header);
+        if (!(header & LOGGER_RECORD_COMMITTED))
+        {
+            break;
+        }
+
+        if (header & LOGGER_RECORD_PAD)
+        {
+            end = AolkmeLogger_BufferAdvance(end, LOGGER_RECORD_LENGTH(header));
+            continue;
+        }
+
+        if (length + LOGGER_RECORD_LENGTH(header) > s_batch_size)
+        {
+            break;
+        }
+        length += LOGGER_RECORD_LENGTH(header);
+        end = AolkmeLogger_BufferAdvance(end, LOGGER_RECORD_SIZE(LOGGER_RECORD_LENGTH(header)));
+    }
+
+    if (end == tail)
+    {
+        return false;
+    }
+
+    if (AolkmeCore_GetState() == AOLKME_CORE_STATE_RUNNING)
+    {
+        // Send to output: outputs with the same level share the chunk
+        uint16_t chunk = 0;
+        int32_t chunk_level = -1;
+        for (uint8_t i = 0; i < g_aolkme_logger_state.output_count; i ++)
+        {
+            E_AolkmeLoggerConsoleLogLevel min_level = g_aolkme_logger_state.outputs[i].min_level;
+            if ((int32_t)min_level != chunk_level)
+            {
+                chunk = AolkmeLogger_BufferGather(end, min_level);
+                chunk_level = (int32_t)min_level;
+            }
+            if (chunk > 0)
+            {
+                g_aolkme_logger_state.outputs[i].func(s_AolkmeLoggerBatch, chunk);
+            }
+        }
+    }
+
+    // Zero the records before handing their bytes back to the producers
+    while (tail != end)
+    {
+        T_AolkmeLoggerRecord *record = AolkmeLogger_BufferAt(tail);
+        uint32_t header = record->header;
+        uint32_t size = (header & LOGGER_RECORD_PAD) ? LOGGER_RECORD_LENGTH(header)
+                                                     : LOGGER_RECORD_SIZE(LOGGER_RECORD_LENGTH(header));
+        memset(record, 0, size);
+        tail = AolkmeLogger_BufferAdvance(tail, size);
+    }
+    AolkmeAtomic_Store32(&s_tail, end);
+
+    if (AolkmeAtomic_Load32(&s_free_waiters) > 0)
+    {
+        T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+        osal_handler->SemaPost(s_AolkmeLoggerFreeSema);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Copy the records from the tail to end that pass min_level into the output chunk.
+ * 
+ * @return Chunk length in bytes.
+ */
+static uint16_t AolkmeLogger_BufferGather(uint32_t end, E_AolkmeLoggerConsoleLogLevel min_level)
+{
+    uint16_t length = 0;
+
+    for (uint32_t pos = s_tail; pos != end; )
+    {
+        T_AolkmeLoggerRecord *record = AolkmeLogger_BufferAt(pos);
+        uint32_t header = record->header;
+        if (header & LOGGER_RECORD_PAD)
+        {
+            pos = AolkmeLogger_BufferAdvance(pos, LOGGER_RECORD_LENGTH(header));
+            continue;
+        }
+
+        if (LOGGER_RECORD_LEVEL(header) <= (uint32_t)min_level)
+        {
+            memcpy(s_AolkmeLoggerBatch + length, record->data, LOGGER_RECORD_LENGTH(header));
+            length += (uint16_t)LOGGER_RECORD_LENGTH(header);
+        }
+        pos = AolkmeLogger_BufferAdvance(pos, LOGGER_RECORD_SIZE(LOGGER_RECORD_LENGTH(header)));
+    }
+    return length;
 }
 
 
@@ -8,6 +8,7 @@
 
 #include "logger_core.h"
 #include "logger_formatter.h"
+#include "Aolkme_atomic.h"
 #include <stdbool.h>
 #include <stdarg.h>
 
@@ -15,6 +16,12 @@
 // Global logger state
 T_AolkmeLoggerState g_aolkme_logger_state = {0};
 
+// Runtime level + 1 for the inline check of the ALOG_* macros, 0: not initialized
+volatile uint8_t g_aolkme_logger_threshold = 0;
+
+// Deferred frame counter
+static volatile uint32_t s_defer_seq = 0;
+
 
 /**
  * @brief Initialize the logger.
@@ -32,16 +39,15 @@ T_AolkmeReturnCode AolkmeLogger_Init(const T_AolkmeLoggerConfig *config)
     g_aolkme_logger_state.global_level = config->level;
     g_aolkme_logger_state.color_enabled = config->isSupportColor;
 
-
-	
     T_AolkmeReturnCode returnCode;
-    returnCode = AolkmeLogger_BufferInit(config->buffer_size);
+    returnCode = AolkmeLogger_BufferInit(config);
     if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
         printf("AolkmeLogger_BufferInit is error\r\n");
         return returnCode;
     }
 
     g_aolkme_logger_state.initialized = true;
+    g_aolkme_logger_threshold = (uint8_t)(config->level + 1);
     return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
 }
 
@@ -62,6 +68,8 @@ T_AolkmeReturnCode AolkmeLogger_Deinit(void)
 
     T_AolkmeReturnCode returnCode;
 
+    g_aolkme_logger_threshold = 0;
+
     returnCode = AolkmeLogger_BufferFlush();
     if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
         printf("AolkmeLogger_BufferFlush is error\r\n");
@@ -79,6 +87,57 @@ T_AolkmeReturnCode AolkmeLogger_Deinit(void)
 }
 
 
+/**
+ * @brief Change the runtime log level.
+ * @param level Most verbose level output from now on.
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeLogger_SetLevel(E_AolkmeLoggerConsoleLogLevel level)
+{
+    if (g_aolkme_logger_state.initialized != true) {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if ((uint32_t)level > AOLKME_LOGGER_CONSOLE_LOG_LEVEL_MAX) {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    // The flush task filters on the output levels: keep them in step, or logs raised past the
+    // inline check would be buffered and then never output
+    g_aolkme_logger_state.global_level = level;
+    for (uint8_t i = 0; i < g_aolkme_logger_state.output_count; i++) {
+        g_aolkme_logger_state.outputs[i].min_level = level;
+    }
+    g_aolkme_logger_threshold = (uint8_t)(level + 1);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+/**
+ * @brief Get the logger counters.
+ * @param stats Counters and record ring usage.
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeLogger_GetStats(T_AolkmeLoggerStats *stats)
+{
+    if (g_aolkme_logger_state.initialized != true) {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    if (stats == NULL) {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    stats->log_count = g_aolkme_logger_state.log_count;
+    stats->unlog_count = g_aolkme_logger_state.unlog_count;
+    stats->drop_buffer_full = g_aolkme_logger_state.drop_buffer_full;
+    stats->truncated_count = g_aolkme_logger_state.truncated_count;
+    AolkmeLogger_BufferStats(stats);
+
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
 /**
  * @brief Add a new output function to the logger.
  * @param output_func The output function to add.
@@ -126,7 +185,7 @@ void AolkmeLogger_Output(E_AolkmeLoggerConsoleLogLevel level, const char *tag,
     }
 
     if (level > g_aolkme_logger_state.global_level) {
-        g_aolkme_logger_state.unlog_count++;
+        AolkmeAtomic_Add32(&g_aolkme_logger_state.unlog_count, 1);
         return;
     }
 
@@ -155,27 +214,57 @@ void AolkmeLogger_Output(E_AolkmeLoggerConsoleLogLevel level, const char *tag,
     if (len > 0)
     {
         // 
-        AolkmeLogger_BufferPut(level, (uint8_t *)formatted, (uint16_t)len);
-        g_aolkme_logger_state.log_count++;
+        // Dropped logs are counted by the buffer
+        if (AolkmeLogger_BufferPut(level, (uint8_t *)formatted, (uint16_t)len) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            AolkmeAtomic_Add32(&g_aolkme_logger_state.log_count, 1);
+        }
     }
 
 }
 
 
 
+/**
+ * @brief Output a deferred log frame.
+ * @param level Log level.
+ * @param id Call site string, see ALOG_DEFER.
+ * @param args Argument words.
+ * @param argc Number of argument words, at most AOLKME_LOGGER_DEFER_MAX_ARGS.
+ */
+void AolkmeLogger_OutputDeferred(E_AolkmeLoggerConsoleLogLevel level, const char *id, const uint32_t *args, uint32_t argc)
+{
+    if (g_aolkme_logger_state.initialized != true) {
+        return;
+    }
 
+    if (level > g_aolkme_logger_state.global_level) {
+        AolkmeAtomic_Add32(&g_aolkme_logger_state.unlog_count, 1);
+        return;
+    }
 
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    if (osal_handler == NULL) {
+        return;
+    }
 
+    // Header and arguments, word aligned
+    uint32_t words[sizeof(T_AolkmeLoggerDeferFrame) / sizeof(uint32_t) + AOLKME_LOGGER_DEFER_MAX_ARGS];
+    T_AolkmeLoggerDeferFrame *frame = (T_AolkmeLoggerDeferFrame *)words;
 
+    if (argc > AOLKME_LOGGER_DEFER_MAX_ARGS) {
+        argc = AOLKME_LOGGER_DEFER_MAX_ARGS;
+    }
 
-
-
-
-
-
-
-
-
-
-
-
+    frame->magic = AOLKME_LOGGER_DEFER_MAGIC;
+    frame->level = (uint8_t)level;
+    frame->argc = (uint8_t)argc;
+    frame->seq = (uint8_t)AolkmeAtomic_Add32(&s_defer_seq, 1);
+    frame->id = (uint32_t)(uintptr_t)id;
+    osal_handler->GetTimeMs(&frame->timestamp);
+    memcpy(frame->args, args, argc * sizeof(uint32_t));
+
+    uint16_t len = (uint16_t)(sizeof(T_AolkmeLoggerDeferFrame) + argc * sizeof(uint32_t));
+    if (AolkmeLogger_BufferPut(level, (uint8_t *)frame, len) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        AolkmeAtomic_Add32(&g_aolkme_logger_state.log_count, 1);
+    }
+}
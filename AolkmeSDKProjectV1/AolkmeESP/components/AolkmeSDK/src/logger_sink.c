@@ -0,0 +1,310 @@
+/**
+ * @file logger_sink.c
+ * @brief 双缓冲异步输出：一半在 DMA 发送时填充另一半，发送完成中断里启动下一半
+ * @author Aolkme
+ * @
+ *
+ */
+
+#include "logger_core.h"
+#include "Aolkme_atomic.h"
+
+#define LOGGER_SINK_HALF            0x80000000u                         // Half being filled, the other one may be on the wire
+#define LOGGER_SINK_BUSY            0x40000000u                         // A transfer is on the wire
+#define LOGGER_SINK_LENGTH(s)       ((s) & 0xFFFFu)
+#define LOGGER_SINK_POLL_MS         10                                  // Wait slice, completions are also seen without SemaPostFromISR
+
+
+
+static bool AolkmeLogger_SinkStart(T_AolkmeLoggerSink *sink, uint32_t state);
+static void AolkmeLogger_SinkIdle(T_AolkmeLoggerSink *sink);
+
+/**
+ * @brief Set up a double buffered sink over buffer (size bytes, split in two halves).
+ *
+ * @param sink
+ * @param buffer Stays owned by the caller; must be reachable by the DMA.
+ * @param size
+ * @param transmit
+ * @param wait_ms Longest wait of one write for a free half.
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkInit(T_AolkmeLoggerSink *sink, uint8_t *buffer, uint32_t size,
+                                         AolkmeLoggerSinkTransmit transmit, uint32_t wait_ms)
+{
+    if (sink == NULL || buffer == NULL || transmit == NULL || size < 2 || size / 2 > 0xFFFFu)
+    {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    if (osal_handler == NULL) {
+        printf("AolkmePlatform_GetOSALHandle is error\r\n");
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    memset(sink, 0, sizeof(T_AolkmeLoggerSink));
+    if (osal_handler->SemaCreate(0, &sink->done_sema) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+    {
+        printf("AolkmeLogger sink done_sema create is error!\r\n");
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_NO_RESOURCE;
+    }
+
+    sink->buffer = buffer;
+    sink->half_size = (uint16_t)(size / 2);
+    sink->transmit = transmit;
+    sink->wait_ms = wait_ms;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+/**
+ * @brief Release the sink. The caller stops the writer and the transfers first.
+ *
+ * @param sink
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkDeinit(T_AolkmeLoggerSink *sink)
+{
+    if (sink == NULL)
+    {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    if (osal_handler != NULL && sink->done_sema != NULL)
+    {
+        osal_handler->SemaDestroy(sink->done_sema);
+    }
+    memset(sink, 0, sizeof(T_AolkmeLoggerSink));
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+/**
+ * @brief Copy data into the fill half and start it when the wire is idle.
+ *
+ * While a transfer is on the wire the data only joins the fill half, which the completion
+ * interrupt starts next. The writer waits only when the fill half is full as well.
+ *
+ * @param sink
+ * @param data
+ * @param dataLen
+ * @return T_AolkmeReturnCode NO_RESOURCE if part of data was dropped after wait_ms.
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkWrite(T_AolkmeLoggerSink *sink, const uint8_t *data, uint16_t dataLen)
+{
+    if (sink == NULL || sink->buffer == NULL)
+    {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    bool waited = false;
+    uint32_t start_ms = 0;
+    uint32_t now_ms;
+
+    while (dataLen > 0)
+    {
+        uint32_t state = AolkmeAtomic_Load32(&sink->state);
+        uint32_t length = LOGGER_SINK_LENGTH(state);
+
+        if (length == sink->half_size)
+        {
+            if (!(state & LOGGER_SINK_BUSY))
+            {
+                AolkmeLogger_SinkStart(sink, state);
+                continue;
+            }
+
+            // Both halves busy. Counted in waiting before the state is checked again, so a
+            // completion after the check has already posted the semaphore.
+            if (!waited)
+            {
+                waited = true;
+                AolkmeAtomic_Add32(&sink->write_waits, 1);
+                osal_handler->GetTimeMs(&start_ms);
+            }
+            osal_handler->GetTimeMs(&now_ms);
+            if (now_ms - start_ms >= sink->wait_ms)
+            {
+                AolkmeAtomic_Add32(&sink->dropped_bytes, dataLen);
+                return AOLKME_ERROR_LOGGER_MODULE_CODE_NO_RESOURCE;
+            }
+
+            AolkmeAtomic_Add32(&sink->waiting, 1);
+            if (AolkmeAtomic_Load32(&sink->state) == state)
+            {
+                uint32_t remaining = sink->wait_ms - (now_ms - start_ms);
+                osal_handler->SemaTimedWait(sink->done_sema, (remaining < LOGGER_SINK_POLL_MS) ? remaining : LOGGER_SINK_POLL_MS);
+            }
+            AolkmeAtomic_Add32(&sink->waiting, (uint32_t)-1);
+            continue;
+        }
+
+        // The interrupt may swap halves meanwhile: it only sends the bytes counted in state,
+        // and a failed publish copies again into the new fill half
+        uint16_t n = (uint16_t)(sink->half_size - length);
+        if (n > dataLen)
+        {
+            n = dataLen;
+        }
+        uint8_t *fill = sink->buffer + ((state & LOGGER_SINK_HALF) ? sink->half_size : 0);
+        memcpy(fill + length, data, n);
+        if (!AolkmeAtomic_CompareExchange32(&sink->state, state, state + n))
+        {
+            continue;
+        }
+        data += n;
+        dataLen -= n;
+    }
+
+    uint32_t state = AolkmeAtomic_Load32(&sink->state);
+    if (!(state & LOGGER_SINK_BUSY) && LOGGER_SINK_LENGTH(state) > 0)
+    {
+        AolkmeLogger_SinkStart(sink, state);
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+/**
+ * @brief Wait up to timeout_ms until both halves are sent.
+ *
+ * @param sink
+ * @param timeout_ms
+ * @return T_AolkmeReturnCode
+ */
+T_AolkmeReturnCode AolkmeLogger_SinkFlush(T_AolkmeLoggerSink *sink, uint32_t timeout_ms)
+{
+    if (sink == NULL || sink->buffer == NULL)
+    {
+        return AOLKME_ERROR_LOGGER_MODULE_CODE_INITIALIZATION_NOT_DONE;
+    }
+
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    uint32_t start_ms;
+    uint32_t now_ms;
+
+    osal_handler->GetTimeMs(&start_ms);
+    for (;;)
+    {
+        uint32_t state = AolkmeAtomic_Load32(&sink->state);
+        if (!(state & LOGGER_SINK_BUSY))
+        {
+            if (LOGGER_SINK_LENGTH(state) == 0)
+            {
+                return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+            }
+            AolkmeLogger_SinkStart(sink, state);
+            continue;
+        }
+
+        osal_handler->GetTimeMs(&now_ms);
+        if (now_ms - start_ms >= timeout_ms)
+        {
+            return AOLKME_ERROR_SYSTEM_MODULE_CODE_TIMEOUT;
+        }
+        osal_handler->TaskSleepMs(1);
+    }
+}
+
+
+
+/**
+ * @brief Transfer done: start the filled half, if any. Call it from the TX complete interrupt.
+ *
+ * Uses no OSAL call except SemaPostFromISR, so it is safe in ISR context.
+ *
+ * @param sink
+ * @param context_switch_required
+ */
+void AolkmeLogger_SinkTxComplete(T_AolkmeLoggerSink *sink, bool *context_switch_required)
+{
+    if (context_switch_required)
+    {
+        *context_switch_required = false;
+    }
+
+    if (sink == NULL || sink->buffer == NULL)
+    {
+        return;
+    }
+
+    AolkmeAtomic_Add32(&sink->transfers, 1);
+    AolkmeAtomic_Add32(&sink->bytes_sent, AolkmeAtomic_Load32(&sink->in_flight));
+
+    for (;;)
+    {
+        uint32_t state = AolkmeAtomic_Load32(&sink->state);
+        if (LOGGER_SINK_LENGTH(state) > 0)
+        {
+            if (AolkmeLogger_SinkStart(sink, state))
+            {
+                break;
+            }
+        }
+        else if (AolkmeAtomic_CompareExchange32(&sink->state, state, state & ~LOGGER_SINK_BUSY))
+        {
+            break;
+        }
+    }
+
+    // Without an ISR-safe post the writer sees the free half on its next wait slice
+    T_AolkmeOSALHandler *osal_handler = AolkmePlatform_GetOSALHandle();
+    if (AolkmeAtomic_Load32(&sink->waiting) != 0 && osal_handler != NULL && osal_handler->SemaPostFromISR != NULL)
+    {
+        int woken = 0;
+        osal_handler->SemaPostFromISR(sink->done_sema, &woken);
+        if (context_switch_required)
+        {
+            *context_switch_required = (woken != 0);
+        }
+    }
+}
+
+
+
+/**
+ * @brief Swap halves and transmit the one filled so far.
+ *
+ * @param state Observed state with bytes in the fill half.
+ * @return false if the state changed first.
+ */
+static bool AolkmeLogger_SinkStart(T_AolkmeLoggerSink *sink, uint32_t state)
+{
+    uint32_t next = ((state & LOGGER_SINK_HALF) ^ LOGGER_SINK_HALF) | LOGGER_SINK_BUSY;
+    if (!AolkmeAtomic_CompareExchange32(&sink->state, state, next))
+    {
+        return false;
+    }
+
+    // Set before the transfer starts: a transmit that completes at once calls TxComplete from inside
+    uint16_t length = (uint16_t)LOGGER_SINK_LENGTH(state);
+    AolkmeAtomic_Store32(&sink->in_flight, length);
+    uint8_t *half = sink->buffer + ((state & LOGGER_SINK_HALF) ? sink->half_size : 0);
+    if (sink->transmit(half, length) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS)
+    {
+        AolkmeAtomic_Add32(&sink->dropped_bytes, length);
+        AolkmeAtomic_Store32(&sink->in_flight, 0);
+        AolkmeLogger_SinkIdle(sink);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Clear the busy flag; the fill half is kept for the next write.
+ */
+static void AolkmeLogger_SinkIdle(T_AolkmeLoggerSink *sink)
+{
+    uint32_t state = AolkmeAtomic_Load32(&sink->state);
+
+    while (!AolkmeAtomic_CompareExchange32(&sink->state, state, state & ~LOGGER_SINK_BUSY))
+    {
+        state = AolkmeAtomic_Load32(&sink->state);
+    }
+}
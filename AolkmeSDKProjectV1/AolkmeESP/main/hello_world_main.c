@@ -37,6 +37,7 @@ void app_main(void)
 	
     T_AolkmeOSALHandler osalHandler = {
         .TaskCreate = A_Osal_TaskCreate,
+        .TaskCreatePinned = A_Osal_TaskCreatePinned,
         .TaskDestroy = A_Osal_TaskDestroy,
         .TaskSleepMs = A_Osal_TaskSleepMs,
         .MutexCreate = A_Osal_MutexCreate,
@@ -49,6 +50,7 @@ void app_main(void)
         .SemaWait = A_Osal_SemaphoreWait,
 		.SemaTimedWait = A_Osal_SemaphoreTimedWait,
         .SemaPost = A_Osal_SemaphorePost,
+        .SemaPostFromISR = A_Osal_SemaphorePostFromISR,
         .GetTimeMs = A_Osal_GetTimeMs,
         .GetRandomNum = A_Osal_GetRandomNum,
         .Malloc = Osal_Malloc,
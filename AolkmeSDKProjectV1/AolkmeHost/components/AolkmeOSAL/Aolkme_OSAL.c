@@ -0,0 +1,620 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             // pthread_setaffinity_np
+#endif
+
+#include "Aolkme_OSAL.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+
+
+#define SEM_MUTEX_WAIT_FOREVER          0xFFFFFFFF
+
+
+
+// 计数/二值信号量（pthread 互斥锁 + 条件变量）
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    uint32_t        count;
+    uint32_t        max;
+} PosixSemaphore;
+
+
+// 定长元素的环形队列
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  notEmpty;
+    pthread_cond_t  notFull;
+    uint8_t        *items;
+    uint32_t        itemSize;
+    uint32_t        length;
+    uint32_t        head;
+    uint32_t        count;
+} PosixQueue;
+
+
+typedef char TaskHandleFitsPointer[(sizeof(pthread_t) <= sizeof(void *)) ? 1 : -1];
+
+
+
+static uint64_t posixNowUs(void);
+static void posixInitCond(pthread_cond_t *cond);
+static const struct timespec *posixDeadline(uint32_t waitTimeMs, struct timespec *deadline);
+static int posixCondWait(pthread_cond_t *cond, pthread_mutex_t *lock, const struct timespec *deadline);
+
+
+
+
+
+
+
+/**
+ * Task_Create
+ * @brief 创建一个任务（pthread，分离运行；栈大小和优先级使用系统默认值）
+ */
+T_AolkmeReturnCode A_Osal_TaskCreate(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, T_AolkmeTaskHandle *task)
+{
+    return A_Osal_TaskCreatePinned(name, taskFunc, stackSize, arg, -1, task);
+}
+
+/**
+ * Task_Create_Pinned
+ * @brief 创建一个任务并绑定到 core（core < 0 不绑定）
+ */
+T_AolkmeReturnCode A_Osal_TaskCreatePinned(const char *name, void *(*taskFunc)(void *), uint32_t stackSize, void *arg, int32_t core, T_AolkmeTaskHandle *task)
+{
+    pthread_t thread;
+
+    (void)stackSize;
+    if (taskFunc == NULL || task == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    if (pthread_create(&thread, NULL, taskFunc, arg) != 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+
+#ifdef __linux__
+    if (core >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+    }
+    if (name) {
+        char shortName[16];     // Linux 线程名最长 15 字符
+        strncpy(shortName, name, sizeof(shortName) - 1);
+        shortName[sizeof(shortName) - 1] = '\0';
+        pthread_setname_np(thread, shortName);
+    }
+#else
+    (void)core;
+    (void)name;
+#endif
+
+    pthread_detach(thread);
+    *task = (T_AolkmeTaskHandle)(uintptr_t)thread;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Task_Destroy
+ * @brief 结束任务；task 为 NULL（任务自身）时任务函数返回即结束
+ */
+T_AolkmeReturnCode A_Osal_TaskDestroy(T_AolkmeTaskHandle task)
+{
+    if (task == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    }
+
+    pthread_t thread = (pthread_t)(uintptr_t)task;
+    if (!pthread_equal(thread, pthread_self())) {
+        pthread_cancel(thread);
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Task_Dealy
+ */
+T_AolkmeReturnCode A_Osal_TaskSleepMs(uint32_t timeMs)
+{
+    struct timespec ts = {
+        .tv_sec = timeMs / 1000,
+        .tv_nsec = (long)(timeMs % 1000) * 1000000L,
+    };
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Mutex_Create
+ */
+T_AolkmeReturnCode A_Osal_MutexCreate(T_AolkmeMutexHandle *mutex)
+{
+    if (mutex == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_t *lock = malloc(sizeof(pthread_mutex_t));
+    if (lock == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    pthread_mutex_init(lock, NULL);
+
+    *mutex = lock;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Mutex_Destry
+ */
+T_AolkmeReturnCode A_Osal_MutexDestroy(T_AolkmeMutexHandle mutex)
+{
+    if (mutex == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_destroy((pthread_mutex_t *)mutex);
+    free(mutex);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Mutex_Lock
+ */
+T_AolkmeReturnCode A_Osal_MutexLock(T_AolkmeMutexHandle mutex)
+{
+    if (mutex == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    if (pthread_mutex_lock((pthread_mutex_t *)mutex) != 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Mutex_Unlock
+ */
+T_AolkmeReturnCode A_Osal_MutexUnlock(T_AolkmeMutexHandle mutex)
+{
+    if (mutex == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    if (pthread_mutex_unlock((pthread_mutex_t *)mutex) != 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Semaphore_Create
+ */
+T_AolkmeReturnCode A_Osal_SemaphoreCreate(uint32_t initValue, T_AolkmeSemaHandle *semaphore)
+{
+    if (semaphore == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    PosixSemaphore *sem = malloc(sizeof(PosixSemaphore));
+    if (sem == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    pthread_mutex_init(&sem->lock, NULL);
+    posixInitCond(&sem->cond);
+    sem->count = initValue;
+    sem->max = UINT32_MAX;
+
+    *semaphore = sem;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Binary_Semaphore_Create
+ */
+T_AolkmeReturnCode A_Osal_BinarySemaphoreCreate(T_AolkmeSemaHandle *semaphore)
+{
+    T_AolkmeReturnCode returnCode = A_Osal_SemaphoreCreate(0, semaphore);
+
+    if (returnCode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        ((PosixSemaphore *)*semaphore)->max = 1;
+    }
+    return returnCode;
+}
+
+/**
+ * Semaphore_Destroy
+ */
+T_AolkmeReturnCode A_Osal_SemaphoreDestroy(T_AolkmeSemaHandle semaphore)
+{
+    PosixSemaphore *sem = (PosixSemaphore *)semaphore;
+
+    if (sem == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->lock);
+    free(sem);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Semaphore_Timed_Wait
+ */
+T_AolkmeReturnCode A_Osal_SemaphoreTimedWait(T_AolkmeSemaHandle semaphore, uint32_t waitTimeMs)
+{
+    PosixSemaphore *sem = (PosixSemaphore *)semaphore;
+    struct timespec deadline;
+    int result = 0;
+
+    if (sem == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    const struct timespec *until = posixDeadline(waitTimeMs, &deadline);
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0 && result == 0) {
+        result = posixCondWait(&sem->cond, &sem->lock, until);
+    }
+    if (sem->count > 0) {
+        sem->count--;
+        result = 0;
+    }
+    pthread_mutex_unlock(&sem->lock);
+
+    if (result != 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Semaphore_Wait
+ */
+T_AolkmeReturnCode A_Osal_SemaphoreWait(T_AolkmeSemaHandle semaphore)
+{
+    return A_Osal_SemaphoreTimedWait(semaphore, SEM_MUTEX_WAIT_FOREVER);
+}
+
+/**
+ * Semaphore_Post
+ */
+T_AolkmeReturnCode A_Osal_SemaphorePost(T_AolkmeSemaHandle semaphore)
+{
+    PosixSemaphore *sem = (PosixSemaphore *)semaphore;
+
+    if (sem == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&sem->lock);
+    if (sem->count < sem->max) {
+        sem->count++;
+    }
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Semaphore_Post_From_ISR
+ */
+T_AolkmeReturnCode A_Osal_SemaphorePostFromISR(T_AolkmeSemaHandle semaphore, int *pxHigherPriorityTaskWoken)
+{
+    if (pxHigherPriorityTaskWoken) {
+        *pxHigherPriorityTaskWoken = 0;
+    }
+    return A_Osal_SemaphorePost(semaphore);
+}
+
+/**
+ * Get_TimeMs
+ */
+T_AolkmeReturnCode A_Osal_GetTimeMs(uint32_t *ms)
+{
+    if (ms == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    *ms = (uint32_t)(posixNowUs() / 1000);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Get_TimeUs
+ */
+T_AolkmeReturnCode A_Osal_GetTimeUs(uint32_t *us)
+{
+    if (us == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    *us = (uint32_t)posixNowUs();
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+/**
+ * Get_Random_Num
+ */
+T_AolkmeReturnCode A_Osal_GetRandomNum(uint16_t *randomNum)
+{
+    if (randomNum == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    *randomNum = (uint16_t)rand();
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+void *Osal_Malloc(uint32_t size)
+{
+    return malloc(size);
+}
+
+void Osal_Free(void *ptr)
+{
+    free(ptr);
+}
+
+
+
+
+
+
+
+/********************** 队列操作补充 **********************/
+
+T_AolkmeReturnCode A_Osal_QueueCreate(uint32_t queueLength, uint32_t itemSize, T_AolkmeQueueHandle *queue)
+{
+    if (queue == NULL || queueLength == 0 || itemSize == 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    PosixQueue *q = malloc(sizeof(PosixQueue));
+    if (q == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    q->items = malloc((size_t)queueLength * itemSize);
+    if (q->items == NULL) {
+        free(q);
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+
+    pthread_mutex_init(&q->lock, NULL);
+    posixInitCond(&q->notEmpty);
+    posixInitCond(&q->notFull);
+    q->itemSize = itemSize;
+    q->length = queueLength;
+    q->head = 0;
+    q->count = 0;
+
+    *queue = q;
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+T_AolkmeReturnCode A_Osal_QueueDestroy(T_AolkmeQueueHandle queue)
+{
+    PosixQueue *q = (PosixQueue *)queue;
+
+    if (q == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_cond_destroy(&q->notFull);
+    pthread_cond_destroy(&q->notEmpty);
+    pthread_mutex_destroy(&q->lock);
+    free(q->items);
+    free(q);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+T_AolkmeReturnCode A_Osal_QueueSend(T_AolkmeQueueHandle queue, const void *item, uint32_t waitTimeMs)
+{
+    PosixQueue *q = (PosixQueue *)queue;
+    struct timespec deadline;
+    int result = 0;
+
+    if (q == NULL || item == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    const struct timespec *until = posixDeadline(waitTimeMs, &deadline);
+    pthread_mutex_lock(&q->lock);
+    while (q->count == q->length && result == 0) {
+        result = (waitTimeMs == 0) ? ETIMEDOUT : posixCondWait(&q->notFull, &q->lock, until);
+    }
+    if (q->count < q->length) {
+        memcpy(q->items + (size_t)((q->head + q->count) % q->length) * q->itemSize, item, q->itemSize);
+        q->count++;
+        pthread_cond_signal(&q->notEmpty);
+        result = 0;
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    if (result != 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+T_AolkmeReturnCode A_Osal_QueueReceive(T_AolkmeQueueHandle queue, void *buffer, uint32_t waitTimeMs)
+{
+    PosixQueue *q = (PosixQueue *)queue;
+    struct timespec deadline;
+    int result = 0;
+
+    if (q == NULL || buffer == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    const struct timespec *until = posixDeadline(waitTimeMs, &deadline);
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0 && result == 0) {
+        result = (waitTimeMs == 0) ? ETIMEDOUT : posixCondWait(&q->notEmpty, &q->lock, until);
+    }
+    if (q->count > 0) {
+        memcpy(buffer, q->items + (size_t)q->head * q->itemSize, q->itemSize);
+        q->head = (q->head + 1) % q->length;
+        q->count--;
+        pthread_cond_signal(&q->notFull);
+        result = 0;
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    if (result != 0) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+    }
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+T_AolkmeReturnCode A_Osal_QueueMessageCount(T_AolkmeQueueHandle queue, uint32_t *count)
+{
+    PosixQueue *q = (PosixQueue *)queue;
+
+    if (q == NULL || count == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    *count = q->count;
+    pthread_mutex_unlock(&q->lock);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+T_AolkmeReturnCode A_Osal_QueueReset(T_AolkmeQueueHandle queue)
+{
+    PosixQueue *q = (PosixQueue *)queue;
+
+    if (q == NULL) {
+        return AOLKME_ERROR_SYSTEM_MODULE_CODE_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    q->head = 0;
+    q->count = 0;
+    pthread_cond_broadcast(&q->notFull);
+    pthread_mutex_unlock(&q->lock);
+    return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+}
+
+
+
+
+
+
+
+const T_AolkmeOSALHandler g_aolkmePosixOsalHandler = {
+    .TaskCreate = A_Osal_TaskCreate,
+    .TaskCreatePinned = A_Osal_TaskCreatePinned,
+    .TaskDestroy = A_Osal_TaskDestroy,
+    .TaskSleepMs = A_Osal_TaskSleepMs,
+    .MutexCreate = A_Osal_MutexCreate,
+    .MutexDestroy = A_Osal_MutexDestroy,
+    .MutexLock = A_Osal_MutexLock,
+    .MutexUnlock = A_Osal_MutexUnlock,
+    .SemaCreate = A_Osal_SemaphoreCreate,
+    .BinarySemaphoreCreate = A_Osal_BinarySemaphoreCreate,
+    .SemaDestroy = A_Osal_SemaphoreDestroy,
+    .SemaWait = A_Osal_SemaphoreWait,
+    .SemaTimedWait = A_Osal_SemaphoreTimedWait,
+    .SemaPost = A_Osal_SemaphorePost,
+    .SemaPostFromISR = A_Osal_SemaphorePostFromISR,
+    .GetTimeMs = A_Osal_GetTimeMs,
+    .GetTimeUs = A_Osal_GetTimeUs,
+    .GetRandomNum = A_Osal_GetRandomNum,
+    .Malloc = Osal_Malloc,
+    .Free = Osal_Free,
+#if AOLKME_OSAL_QUEUE
+    .QueueCreate = A_Osal_QueueCreate,
+    .QueueDestroy = A_Osal_QueueDestroy,
+    .QueueSend = A_Osal_QueueSend,
+    .QueueReceive = A_Osal_QueueReceive,
+    .QueueMessageCount = A_Osal_QueueMessageCount,
+    .QueueReset = A_Osal_QueueReset,
+#endif
+};
+
+
+
+
+
+
+
+/**
+ * @brief Monotonic microseconds since the first call.
+ */
+static uint64_t posixNowUs(void)
+{
+    static uint64_t startUs;
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t nowUs = (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+
+    if (startUs == 0) {
+        startUs = nowUs;
+    }
+    return nowUs - startUs;
+}
+
+
+/**
+ * @brief Condition variable timed against CLOCK_MONOTONIC, so waits ignore wall-clock jumps.
+ */
+static void posixInitCond(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+
+/**
+ * @brief Absolute CLOCK_MONOTONIC time waitTimeMs from now.
+ *
+ * @return deadline, NULL for SEM_MUTEX_WAIT_FOREVER
+ */
+static const struct timespec *posixDeadline(uint32_t waitTimeMs, struct timespec *deadline)
+{
+    if (waitTimeMs == SEM_MUTEX_WAIT_FOREVER) {
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += waitTimeMs / 1000;
+    deadline->tv_nsec += (long)(waitTimeMs % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+
+/**
+ * @brief Wait on cond until deadline (NULL: no limit).
+ *
+ * @return 0 when signalled (or woken spuriously), ETIMEDOUT on timeout
+ */
+static int posixCondWait(pthread_cond_t *cond, pthread_mutex_t *lock, const struct timespec *deadline)
+{
+    if (deadline == NULL) {
+        return pthread_cond_wait(cond, lock);
+    }
+    return pthread_cond_timedwait(cond, lock, deadline);
+}
@@ -0,0 +1,740 @@
+/**
+ * @file event_bench.c
+ * @author Aolkme
+ * @brief 主机端事件系统基准测试：用合成事件测量发布延迟、分发吞吐和队列满比例
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法: aolkme_event_bench [events] [compare | priority | burst | workers]
+ *   events   每个发布任务每轮发布的事件数（默认 20000）；priority 时为高优先级事件数（建议 1000）；
+ *            burst 时共发布 events 个事件，分成每组 BENCH_BURST_EVENTS 个；workers 时为每个事件ID的事件数（建议 400）
+ *   compare  对 1..8 个发布任务分别用 AOLKME_EVENT_QUEUE_MUTEX 和 AOLKME_EVENT_QUEUE_LOCKFREE
+ *            各运行一轮（队列 BENCH_COMPARE_QUEUE_SIZE，1 个处理函数），对比两种队列的发布延迟和每秒事件数
+ *   priority BENCH_LOW_PUBLISHERS 个任务以最低优先级不停发布，使低优先级队列一直满，
+ *            处理函数每个耗时 BENCH_LOW_WORK_US；同时每毫秒发布一个最高优先级事件，
+ *            测量其从发布到处理函数开始执行的延迟（us，平均值、p50/p99 和最坏值）。
+ *            分别用单一 FIFO 和 MAX_EVENT_SYSTEM_PRIORITY_LANES 个严格优先级队列运行
+ *   burst    事件任务空闲时一次发布 BENCH_BURST_EVENTS 个事件，组间空闲 BENCH_BURST_IDLE_MS；
+ *            通过包装主机 OSAL 的 MutexLock 统计每个事件的互斥锁次数（发布侧和事件任务侧分开）
+ *            和 AolkmeCore_GetState 次数（核心互斥锁），以及突发开始到最后一个事件分发完毕的每秒事件数，
+ *            两种队列各运行一轮
+ *   workers  BENCH_WORKER_IDS 个事件ID轮流发布，每个ID一个处理函数，每次固定耗时 BENCH_WORKER_WORK_US；
+ *            worker_count 分别为 1、2、4，输出全部事件处理完的耗时、每秒事件数、相对 1 个任务的加速比，
+ *            以及同一ID内顺序错乱的事件数（应为 0）
+ *
+ * 默认对发布任务数 × 队列大小 × 处理函数个数的每个组合重新初始化事件系统并运行一轮：
+ * 各发布任务同时尽快发布，每次 AolkmeEvent_PublishEvent 用 A_Osal_GetTimeUs 计时，
+ * 成功发布的样本存入本工具自己的缓冲（不使用事件系统的延迟直方图），排序后输出平均值和 p50/p90/p99/max；
+ * 队列满时让出 CPU 后重试，被拒绝的调用计入队列满比例；
+ * 分发吞吐为全部事件从开始发布到处理完毕每秒分发的事件数。
+ * 作为每次事件系统修改前后的回归基线。
+ */
+
+
+#include "Aolkme_core.h"
+#include "Aolkme_event.h"
+#include "Aolkme_event_types.h"
+#include "Aolkme_OSAL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+#define BENCH_MAX_PUBLISHERS    8
+#define BENCH_MAX_HANDLERS      8
+#define BENCH_COMPARE_QUEUE_SIZE 256
+#define BENCH_LOW_PUBLISHERS    4
+#define BENCH_LOW_WORK_US       20
+#define BENCH_PRIORITY_QUEUE_SIZE 64
+#define BENCH_BURST_EVENTS      1000
+#define BENCH_BURST_IDLE_MS     10
+#define BENCH_WORKER_IDS        16
+#define BENCH_WORKER_WORK_US    200
+#define BENCH_WORKER_QUEUE_SIZE 64
+
+
+
+typedef struct {
+    uint32_t events;
+    uint32_t *samples;                  // Publish time of every accepted event, us
+    uint32_t full;                      // Calls refused with EVENT_QUEUE_FULL, then retried
+    uint32_t failed;                    // Calls refused for any other reason
+    T_AolkmeSemaHandle start;
+    T_AolkmeSemaHandle done;
+} T_BenchPublisher;
+
+
+typedef struct {
+    E_AolkmeEventQueueMode queueMode;
+    uint8_t publishers;
+    uint16_t queueSize;
+    uint8_t handlers;
+} T_BenchConfig;
+
+
+
+static bool benchRun(const T_BenchConfig *config, uint32_t events);
+static void *benchPublisherTask(void *arg);
+static bool benchPriorityRun(uint8_t lanes, uint32_t events);
+static void *benchLowPublisherTask(void *arg);
+static void benchLowHandler(const T_AolkmeEvent *event);
+static void benchHighHandler(const T_AolkmeEvent *event);
+static bool benchBurstRun(E_AolkmeEventQueueMode queueMode, uint32_t bursts);
+static void benchBurstHandler(const T_AolkmeEvent *event);
+static bool benchWorkersRun(uint8_t workers, uint32_t events, double *seconds);
+static void benchWorkerHandler(const T_AolkmeEvent *event);
+static T_AolkmeReturnCode benchMutexCreate(T_AolkmeMutexHandle *mutex);
+static T_AolkmeReturnCode benchMutexLock(T_AolkmeMutexHandle mutex);
+static int benchCompare(const void *a, const void *b);
+static uint32_t benchPercentile(const uint32_t *sorted, uint32_t count, uint8_t percent);
+
+
+
+// Empty handlers: the run measures the event system alone
+#define BENCH_HANDLER(n)    static void benchHandler##n(const T_AolkmeEvent *event) { (void)event; }
+BENCH_HANDLER(0) BENCH_HANDLER(1) BENCH_HANDLER(2) BENCH_HANDLER(3)
+BENCH_HANDLER(4) BENCH_HANDLER(5) BENCH_HANDLER(6) BENCH_HANDLER(7)
+
+static const AolkmeEventRefHandler s_benchHandlers[BENCH_MAX_HANDLERS] = {
+    benchHandler0, benchHandler1, benchHandler2, benchHandler3,
+    benchHandler4, benchHandler5, benchHandler6, benchHandler7,
+};
+
+static const uint8_t s_benchPublishers[] = { 1, 2, 4, 8 };
+static const uint16_t s_benchQueueSizes[] = { 16, 64, 256 };
+static const uint8_t s_benchHandlerCounts[] = { 1, 4, 8 };
+
+#define BENCH_COUNT_OF(array)   (sizeof(array) / sizeof((array)[0]))
+
+// Priority run: dispatch latency of every high priority event, written by the event task
+static uint32_t *s_benchHighUs = NULL;
+static uint32_t s_benchHighMax = 0;
+static volatile uint32_t s_benchHighCount = 0;
+static volatile bool s_benchLowRunning = false;
+
+// Burst run: the host OSAL with counting mutexes. The first mutex is the core's, created
+// by Aolkme_Core_Init, and AolkmeCore_GetState takes it on every call.
+static T_AolkmeOSALHandler s_benchOsal;
+static T_AolkmeMutexHandle s_benchCoreMutex = NULL;
+static volatile bool s_benchCounting = false;
+static __thread bool t_benchPublishing = false;
+static uint32_t s_benchPublishLocks = 0;
+static uint32_t s_benchDispatchLocks = 0;
+static uint32_t s_benchCoreLocks = 0;
+static volatile uint32_t s_benchBurstDispatched = 0;
+static uint32_t s_benchBurstEndUs = 0;
+static T_AolkmeSemaHandle s_benchBurstDone = NULL;
+
+// Workers run: next expected sequence number per ID; each ID is dispatched by one worker only
+static const uint8_t s_benchWorkerCounts[] = { 1, 2, 4 };
+static uint32_t s_benchWorkerNext[BENCH_WORKER_IDS];
+static uint32_t s_benchWorkerDispatched = 0;
+static uint32_t s_benchWorkerOutOfOrder = 0;
+
+
+
+
+
+
+
+int main(int argc, char *argv[])
+{
+    uint32_t events = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20000;
+    bool compare = (argc > 2) && (strcmp(argv[2], "compare") == 0);
+    bool priority = (argc > 2) && (strcmp(argv[2], "priority") == 0);
+    bool burst = (argc > 2) && (strcmp(argv[2], "burst") == 0);
+    bool workers = (argc > 2) && (strcmp(argv[2], "workers") == 0);
+
+    if (events == 0 || (argc > 2 && !compare && !priority && !burst && !workers)) {
+        printf("usage: %s [events] [compare | priority | burst | workers]\n", argv[0]);
+        return 1;
+    }
+
+    T_AolkmeUserInfo userInfo = {
+        .appName = "AolkmeSDK",
+        .appId = "AolkmeEvtBench",
+        .appVersion = "0.1",
+    };
+
+    s_benchOsal = g_aolkmePosixOsalHandler;
+    s_benchOsal.MutexCreate = benchMutexCreate;
+    s_benchOsal.MutexLock = benchMutexLock;
+
+    // The event tasks only dispatch while the core is running
+    if (AolkmePlatform_RegOSALHandle(&s_benchOsal) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        Aolkme_Core_Init(&userInfo) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        Aolkme_Core_Application_Start() != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("Aolkme init is error\n");
+        return 1;
+    }
+
+    // Same high priority load behind a single FIFO, then in its own lane
+    if (priority) {
+        printf("%u high priority events, one per ms, %u low priority publishers, dispatch latency in us\n",
+               (unsigned)events, BENCH_LOW_PUBLISHERS);
+        printf("lanes |    avg   p50   p99   max | high full | low dispatched | lane 0 overflow\n");
+        return (benchPriorityRun(1, events) && benchPriorityRun(MAX_EVENT_SYSTEM_PRIORITY_LANES, events)) ? 0 : 1;
+    }
+
+    // Idle event task, then a whole burst at once
+    if (burst) {
+        uint32_t bursts = (events + BENCH_BURST_EVENTS - 1) / BENCH_BURST_EVENTS;
+        printf("%u bursts of %u events, per event counts\n", (unsigned)bursts, BENCH_BURST_EVENTS);
+        printf("mode     | publish locks | dispatch locks | core state reads | events/s\n");
+        return (benchBurstRun(AOLKME_EVENT_QUEUE_MUTEX, bursts) &&
+                benchBurstRun(AOLKME_EVENT_QUEUE_LOCKFREE, bursts)) ? 0 : 1;
+    }
+
+    // Same independent IDs spread over more event tasks each round
+    if (workers) {
+        double seconds[BENCH_COUNT_OF(s_benchWorkerCounts)];
+        printf("%u IDs x %u events, %u us handler\n", BENCH_WORKER_IDS, (unsigned)events, BENCH_WORKER_WORK_US);
+        printf("workers | elapsed s | events/s | speedup | out of order\n");
+        for (size_t w = 0; w < BENCH_COUNT_OF(s_benchWorkerCounts); w++) {
+            if (!benchWorkersRun(s_benchWorkerCounts[w], events, &seconds[w])) {
+                return 1;
+            }
+            printf("%7u | %9.3f | %8.0f | %7.2f | %12u\n", (unsigned)s_benchWorkerCounts[w], seconds[w],
+                   (double)BENCH_WORKER_IDS * events / seconds[w], seconds[0] / seconds[w],
+                   (unsigned)s_benchWorkerOutOfOrder);
+        }
+        return 0;
+    }
+
+    printf("%u events per publisher, publish latency in us\n", (unsigned)events);
+    printf("mode     pub queue handlers |    avg   p50   p90   p99   max | dispatch/s | queue full\n");
+
+    // Same load on both queues, one publisher more each round
+    if (compare) {
+        for (uint8_t p = 1; p <= BENCH_MAX_PUBLISHERS; p++) {
+            T_BenchConfig mutex = { AOLKME_EVENT_QUEUE_MUTEX, p, BENCH_COMPARE_QUEUE_SIZE, 1 };
+            T_BenchConfig lockfree = { AOLKME_EVENT_QUEUE_LOCKFREE, p, BENCH_COMPARE_QUEUE_SIZE, 1 };
+            if (!benchRun(&mutex, events) || !benchRun(&lockfree, events)) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    for (size_t p = 0; p < BENCH_COUNT_OF(s_benchPublishers); p++) {
+        for (size_t q = 0; q < BENCH_COUNT_OF(s_benchQueueSizes); q++) {
+            for (size_t h = 0; h < BENCH_COUNT_OF(s_benchHandlerCounts); h++) {
+                T_BenchConfig config = { AOLKME_EVENT_QUEUE_MUTEX, s_benchPublishers[p], s_benchQueueSizes[q],
+                                         s_benchHandlerCounts[h] };
+                if (!benchRun(&config, events)) {
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+
+
+
+
+
+
+/**
+ * @brief One run: fresh event system, all publishers released at once, wait for the queues to drain.
+ */
+static bool benchRun(const T_BenchConfig *config, uint32_t events)
+{
+    T_AolkmeEventSystemConfig eventConfig = {
+        .queue_size = config->queueSize,
+        .task_stack_size = 2048,
+        .task_priority = 5,
+        .max_handlers = 32,
+        .enable_auto_processing = true,
+        .queue_mode = config->queueMode,
+    };
+
+    if (AolkmeEvent_Init(&eventConfig) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("AolkmeEvent_Init is error\n");
+        return false;
+    }
+    for (uint8_t i = 0; i < config->handlers; i++) {
+        AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_SENSOR_DATA_READY, s_benchHandlers[i]);
+    }
+
+    T_BenchPublisher publisher[BENCH_MAX_PUBLISHERS];
+    T_AolkmeSemaHandle start, done;
+    T_AolkmeTaskHandle task;
+    uint32_t *samples = malloc((size_t)config->publishers * events * sizeof(uint32_t));
+    if (samples == NULL) {
+        printf("out of memory\n");
+        AolkmeEvent_Deinit();
+        return false;
+    }
+    A_Osal_SemaphoreCreate(0, &start);
+    A_Osal_SemaphoreCreate(0, &done);
+
+    for (uint8_t i = 0; i < config->publishers; i++) {
+        publisher[i] = (T_BenchPublisher) { events, samples + (size_t)i * events, 0, 0, start, done };
+        A_Osal_TaskCreate("BenchPublisher", benchPublisherTask, 4096, &publisher[i], &task);
+    }
+
+    uint32_t startUs, endUs;
+    A_Osal_GetTimeUs(&startUs);
+    for (uint8_t i = 0; i < config->publishers; i++) {
+        A_Osal_SemaphorePost(start);
+    }
+    for (uint8_t i = 0; i < config->publishers; i++) {
+        A_Osal_SemaphoreWait(done);
+    }
+
+    // Wait for the event task to drain the queue
+    T_AolkmeEventStats stats;
+    do {
+        A_Osal_TaskSleepMs(1);
+        AolkmeEvent_GetStats(&stats);
+    } while (stats.queue_depth != 0);
+    A_Osal_GetTimeUs(&endUs);
+
+    uint32_t full = 0;
+    uint32_t failed = 0;
+    for (uint8_t i = 0; i < config->publishers; i++) {
+        full += publisher[i].full;
+        failed += publisher[i].failed;
+    }
+
+    uint32_t count = (uint32_t)config->publishers * events;
+    uint64_t totalUs = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        totalUs += samples[i];
+    }
+    qsort(samples, count, sizeof(uint32_t), benchCompare);
+
+    double seconds = (double)(endUs - startUs) / 1e6;
+    printf("%-8s %3u %5u %8u | %6.2f %5u %5u %5u %5u | %10.0f | %6.2f%%\n",
+           (config->queueMode == AOLKME_EVENT_QUEUE_LOCKFREE) ? "lockfree" : "mutex",
+           (unsigned)config->publishers, (unsigned)config->queueSize, (unsigned)config->handlers,
+           (double)totalUs / count, (unsigned)benchPercentile(samples, count, 50), (unsigned)benchPercentile(samples, count, 90),
+           (unsigned)benchPercentile(samples, count, 99), (unsigned)samples[count - 1],
+           stats.dispatch_count / seconds, 100.0 * full / (count + full));
+    if (failed != 0) {
+        printf("  %u publishes failed\n", (unsigned)failed);
+    }
+
+    A_Osal_SemaphoreDestroy(start);
+    A_Osal_SemaphoreDestroy(done);
+    free(samples);
+    AolkmeEvent_Deinit();
+    return failed == 0;
+}
+
+
+/**
+ * @brief Publish as fast as possible and time every accepted call. A full queue is retried
+ * after yielding to the event task.
+ */
+static void *benchPublisherTask(void *arg)
+{
+    T_BenchPublisher *publisher = (T_BenchPublisher *)arg;
+    uint32_t beforeUs, afterUs;
+
+    A_Osal_SemaphoreWait(publisher->start);
+    for (uint32_t i = 0; i < publisher->events; ) {
+        T_AolkmeEvent event = {
+            .ID = AOLKME_EVENT_SENSOR_DATA_READY,
+            .source = publisher,
+        };
+
+        A_Osal_GetTimeUs(&beforeUs);
+        T_AolkmeReturnCode returnCode = AolkmeEvent_PublishEvent(&event);
+        A_Osal_GetTimeUs(&afterUs);
+
+        if (returnCode == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+            publisher->full++;
+            A_Osal_TaskSleepMs(0);
+            continue;
+        }
+        if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            publisher->failed++;
+        }
+        publisher->samples[i++] = afterUs - beforeUs;
+    }
+    A_Osal_SemaphorePost(publisher->done);
+    return NULL;
+}
+
+
+/**
+ * @brief Latency of high priority events while the low priority lane stays full.
+ *
+ * @param lanes 1: every priority shares one FIFO
+ * @param events High priority events to publish
+ */
+static bool benchPriorityRun(uint8_t lanes, uint32_t events)
+{
+    T_AolkmeEventSystemConfig eventConfig = {
+        .queue_size = BENCH_PRIORITY_QUEUE_SIZE,
+        .task_stack_size = 2048,
+        .task_priority = 5,
+        .max_handlers = 32,
+        .enable_auto_processing = true,
+        .priority_lanes = lanes,
+    };
+
+    s_benchHighUs = malloc(events * sizeof(uint32_t));
+    if (s_benchHighUs == NULL) {
+        printf("out of memory\n");
+        return false;
+    }
+    s_benchHighMax = events;
+    s_benchHighCount = 0;
+
+    if (AolkmeEvent_Init(&eventConfig) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("AolkmeEvent_Init is error\n");
+        free(s_benchHighUs);
+        return false;
+    }
+    AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_SENSOR_DATA_READY, benchLowHandler);
+    AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_SYSTEM_ERROR, benchHighHandler);
+
+    T_BenchPublisher publisher[BENCH_LOW_PUBLISHERS];
+    T_AolkmeSemaHandle start, done;
+    T_AolkmeTaskHandle task;
+    A_Osal_SemaphoreCreate(0, &start);
+    A_Osal_SemaphoreCreate(0, &done);
+
+    s_benchLowRunning = true;
+    for (uint8_t i = 0; i < BENCH_LOW_PUBLISHERS; i++) {
+        publisher[i] = (T_BenchPublisher) { 0, NULL, 0, 0, start, done };
+        A_Osal_TaskCreate("BenchLowPublisher", benchLowPublisherTask, 4096, &publisher[i], &task);
+        A_Osal_SemaphorePost(start);
+    }
+
+    // Let the low lane fill up first
+    A_Osal_TaskSleepMs(10);
+
+    // The latency counts from the first attempt, a full FIFO delays the event as well
+    uint32_t highFull = 0;
+    for (uint32_t i = 0; i < events; i++) {
+        uint32_t publishUs;
+        A_Osal_GetTimeUs(&publishUs);
+
+        T_AolkmeEvent event = {
+            .ID = AOLKME_EVENT_SYSTEM_ERROR,
+            .source = (void *)(uintptr_t)publishUs,
+            .flags = EVENT_FLAG_PRIORITY(MAX_EVENT_SYSTEM_PRIORITY_LANES - 1),
+        };
+        while (AolkmeEvent_PublishEvent(&event) == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+            highFull++;
+            A_Osal_TaskSleepMs(0);
+        }
+        A_Osal_TaskSleepMs(1);
+    }
+
+    while (s_benchHighCount < events) {
+        A_Osal_TaskSleepMs(1);
+    }
+
+    s_benchLowRunning = false;
+    for (uint8_t i = 0; i < BENCH_LOW_PUBLISHERS; i++) {
+        A_Osal_SemaphoreWait(done);
+    }
+
+    T_AolkmeEventStats stats;
+    do {
+        A_Osal_TaskSleepMs(1);
+        AolkmeEvent_GetStats(&stats);
+    } while (stats.queue_depth != 0);
+
+    T_AolkmeEventLaneStatus lane;
+    AolkmeEvent_GetLaneStatus(0, &lane);
+
+    uint64_t totalUs = 0;
+    for (uint32_t i = 0; i < events; i++) {
+        totalUs += s_benchHighUs[i];
+    }
+    qsort(s_benchHighUs, events, sizeof(uint32_t), benchCompare);
+
+    printf("%5u | %6.1f %5u %5u %5u | %9u | %14u | %15u\n",
+           (unsigned)lanes, (double)totalUs / events,
+           (unsigned)benchPercentile(s_benchHighUs, events, 50), (unsigned)benchPercentile(s_benchHighUs, events, 99),
+           (unsigned)s_benchHighUs[events - 1], (unsigned)highFull,
+           (unsigned)(stats.dispatch_count - events), (unsigned)lane.overflow_count);
+
+    A_Osal_SemaphoreDestroy(start);
+    A_Osal_SemaphoreDestroy(done);
+    AolkmeEvent_Deinit();
+    free(s_benchHighUs);
+    s_benchHighUs = NULL;
+    return true;
+}
+
+
+/**
+ * @brief Keep the lowest priority lane full until the run ends.
+ */
+static void *benchLowPublisherTask(void *arg)
+{
+    T_BenchPublisher *publisher = (T_BenchPublisher *)arg;
+
+    A_Osal_SemaphoreWait(publisher->start);
+    while (s_benchLowRunning) {
+        T_AolkmeEvent event = {
+            .ID = AOLKME_EVENT_SENSOR_DATA_READY,
+            .source = publisher,
+            .flags = EVENT_FLAG_PRIORITY(0),
+        };
+
+        if (AolkmeEvent_PublishEvent(&event) == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+            publisher->full++;
+            A_Osal_TaskSleepMs(0);
+        }
+    }
+    A_Osal_SemaphorePost(publisher->done);
+    return NULL;
+}
+
+
+/**
+ * @brief Low priority work: busy for BENCH_LOW_WORK_US.
+ */
+static void benchLowHandler(const T_AolkmeEvent *event)
+{
+    uint32_t startUs, nowUs;
+
+    (void)event;
+    A_Osal_GetTimeUs(&startUs);
+    do {
+        A_Osal_GetTimeUs(&nowUs);
+    } while (nowUs - startUs < BENCH_LOW_WORK_US);
+}
+
+
+/**
+ * @brief Record the publish to dispatch latency; source carries the publish time.
+ */
+static void benchHighHandler(const T_AolkmeEvent *event)
+{
+    uint32_t nowUs;
+
+    A_Osal_GetTimeUs(&nowUs);
+    if (s_benchHighCount < s_benchHighMax) {
+        s_benchHighUs[s_benchHighCount] = nowUs - (uint32_t)(uintptr_t)event->source;
+        s_benchHighCount++;
+    }
+}
+
+
+/**
+ * @brief Bursts of BENCH_BURST_EVENTS published while the event task is idle; counts the
+ * mutex locks and core state reads they cost.
+ */
+static bool benchBurstRun(E_AolkmeEventQueueMode queueMode, uint32_t bursts)
+{
+    T_AolkmeEventSystemConfig eventConfig = {
+        .queue_size = 2 * BENCH_BURST_EVENTS,
+        .task_stack_size = 2048,
+        .task_priority = 5,
+        .max_handlers = 32,
+        .enable_auto_processing = true,
+        .queue_mode = queueMode,
+    };
+
+    if (AolkmeEvent_Init(&eventConfig) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("AolkmeEvent_Init is error\n");
+        return false;
+    }
+    AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_SENSOR_DATA_READY, benchBurstHandler);
+    A_Osal_SemaphoreCreate(0, &s_benchBurstDone);
+
+    uint64_t publishLocks = 0;
+    uint64_t dispatchLocks = 0;
+    uint64_t coreLocks = 0;
+    uint64_t elapsedUs = 0;
+    uint32_t failed = 0;
+
+    for (uint32_t b = 0; b < bursts; b++) {
+        uint32_t startUs;
+
+        A_Osal_TaskSleepMs(BENCH_BURST_IDLE_MS);
+        s_benchPublishLocks = 0;
+        s_benchDispatchLocks = 0;
+        s_benchCoreLocks = 0;
+        s_benchBurstDispatched = 0;
+        s_benchCounting = true;
+
+        A_Osal_GetTimeUs(&startUs);
+        t_benchPublishing = true;
+        for (uint32_t i = 0; i < BENCH_BURST_EVENTS; i++) {
+            T_AolkmeEvent event = {
+                .ID = AOLKME_EVENT_SENSOR_DATA_READY,
+            };
+            if (AolkmeEvent_PublishEvent(&event) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+                failed++;
+                s_benchBurstDispatched++;
+            }
+        }
+        t_benchPublishing = false;
+        A_Osal_SemaphoreWait(s_benchBurstDone);
+
+        // The event task goes back to sleep before counting stops
+        A_Osal_TaskSleepMs(2);
+        s_benchCounting = false;
+
+        elapsedUs += s_benchBurstEndUs - startUs;
+        publishLocks += s_benchPublishLocks;
+        dispatchLocks += s_benchDispatchLocks;
+        coreLocks += s_benchCoreLocks;
+    }
+
+    double events = (double)bursts * BENCH_BURST_EVENTS;
+    printf("%-8s | %13.3f | %14.3f | %16.3f | %8.0f\n",
+           (queueMode == AOLKME_EVENT_QUEUE_LOCKFREE) ? "lockfree" : "mutex",
+           publishLocks / events, dispatchLocks / events, coreLocks / events,
+           elapsedUs ? events * 1e6 / elapsedUs : 0.0);
+    if (failed != 0) {
+        printf("  %u publishes failed\n", (unsigned)failed);
+    }
+
+    AolkmeEvent_Deinit();
+    A_Osal_SemaphoreDestroy(s_benchBurstDone);
+    return failed == 0;
+}
+
+
+static void benchBurstHandler(const T_AolkmeEvent *event)
+{
+    (void)event;
+    if (++s_benchBurstDispatched == BENCH_BURST_EVENTS) {
+        A_Osal_GetTimeUs(&s_benchBurstEndUs);
+        A_Osal_SemaphorePost(s_benchBurstDone);
+    }
+}
+
+
+/**
+ * @brief Publish events for every ID in turn and time until the last one is handled.
+ *
+ * @param workers worker_count of the event system
+ * @param events Events per ID
+ * @param seconds From the first publish to the last handler return
+ */
+static bool benchWorkersRun(uint8_t workers, uint32_t events, double *seconds)
+{
+    T_AolkmeEventSystemConfig eventConfig = {
+        .queue_size = BENCH_WORKER_QUEUE_SIZE,
+        .task_stack_size = 2048,
+        .task_priority = 5,
+        .max_handlers = 32,
+        .enable_auto_processing = true,
+        .worker_count = workers,
+    };
+
+    if (AolkmeEvent_Init(&eventConfig) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("AolkmeEvent_Init is error\n");
+        return false;
+    }
+    for (uint32_t id = 0; id < BENCH_WORKER_IDS; id++) {
+        AolkmeEvent_SubscribeEventIdRef(AOLKME_EVENT_USER_BASE + id, benchWorkerHandler);
+    }
+    memset(s_benchWorkerNext, 0, sizeof(s_benchWorkerNext));
+    s_benchWorkerDispatched = 0;
+    s_benchWorkerOutOfOrder = 0;
+
+    uint32_t total = BENCH_WORKER_IDS * events;
+    uint32_t failed = 0;
+    uint32_t startUs, endUs;
+    A_Osal_GetTimeUs(&startUs);
+    for (uint32_t i = 0; i < events; i++) {
+        for (uint32_t id = 0; id < BENCH_WORKER_IDS; id++) {
+            T_AolkmeEvent event = {
+                .ID = AOLKME_EVENT_USER_BASE + id,
+                .source = (void *)(uintptr_t)i,
+            };
+            T_AolkmeReturnCode returnCode;
+            while ((returnCode = AolkmeEvent_PublishEvent(&event)) == AOLKME_ERROR_EVENT_MODULE_CODE_EVENT_QUEUE_FULL) {
+                A_Osal_TaskSleepMs(0);
+            }
+            if (returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+                failed++;
+            }
+        }
+    }
+    while (__atomic_load_n(&s_benchWorkerDispatched, __ATOMIC_ACQUIRE) + failed < total) {
+        A_Osal_TaskSleepMs(1);
+    }
+    A_Osal_GetTimeUs(&endUs);
+    *seconds = (double)(endUs - startUs) / 1e6;
+
+    if (failed != 0) {
+        printf("  %u publishes failed\n", (unsigned)failed);
+    }
+    AolkmeEvent_Deinit();
+    return failed == 0;
+}
+
+
+/**
+ * @brief Fixed cost work: busy for BENCH_WORKER_WORK_US, then check the per ID order.
+ */
+static void benchWorkerHandler(const T_AolkmeEvent *event)
+{
+    uint32_t id = event->ID - AOLKME_EVENT_USER_BASE;
+    uint32_t sequence = (uint32_t)(uintptr_t)event->source;
+    uint32_t startUs, nowUs;
+
+    A_Osal_GetTimeUs(&startUs);
+    do {
+        A_Osal_GetTimeUs(&nowUs);
+    } while (nowUs - startUs < BENCH_WORKER_WORK_US);
+
+    if (id < BENCH_WORKER_IDS) {
+        if (sequence != s_benchWorkerNext[id]) {
+            __atomic_fetch_add(&s_benchWorkerOutOfOrder, 1, __ATOMIC_RELAXED);
+        }
+        s_benchWorkerNext[id] = sequence + 1;
+    }
+    __atomic_fetch_add(&s_benchWorkerDispatched, 1, __ATOMIC_RELEASE);
+}
+
+
+static T_AolkmeReturnCode benchMutexCreate(T_AolkmeMutexHandle *mutex)
+{
+    T_AolkmeReturnCode returnCode = A_Osal_MutexCreate(mutex);
+
+    if (returnCode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS && s_benchCoreMutex == NULL) {
+        s_benchCoreMutex = *mutex;
+    }
+    return returnCode;
+}
+
+
+/**
+ * @brief Count the lock by kind while a burst runs: core state, publisher or event task.
+ */
+static T_AolkmeReturnCode benchMutexLock(T_AolkmeMutexHandle mutex)
+{
+    if (s_benchCounting) {
+        uint32_t *counter = (mutex == s_benchCoreMutex) ? &s_benchCoreLocks :
+                            t_benchPublishing ? &s_benchPublishLocks : &s_benchDispatchLocks;
+        __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+    }
+    return A_Osal_MutexLock(mutex);
+}
+
+
+static int benchCompare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Nearest-rank percentile of sorted samples.
+ */
+static uint32_t benchPercentile(const uint32_t *sorted, uint32_t count, uint8_t percent)
+{
+    uint64_t rank = ((uint64_t)count * percent + 99) / 100;
+    return sorted[(rank > 0) ? rank - 1 : 0];
+}
@@ -0,0 +1,285 @@
+/**
+ * @file event_replay.c
+ * @author Aolkme
+ * @brief 主机端事件回放：把设备上 AolkmeEvent_TraceDump() 导出的轨迹重新发布到 Linux 上的事件系统，
+ *        用真实流量对比处理函数修改前后的性能
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法: aolkme_event_replay <trace.bin> [speed] [workers] [publishers] [queue_size] [handlers]
+ *   speed      1 = 原始节奏（默认），n = 加速 n 倍，0 = 不等待，尽可能快（队列满时阻塞等待）
+ *   workers    事件任务数（默认 1）
+ *   publishers 同时回放轨迹的发布任务数（默认 1），每个任务完整回放一遍
+ *   queue_size 每个事件任务的队列大小（默认 256）
+ *   handlers   默认处理函数个数，每个都订阅全部事件（默认 1，最多 REPLAY_MAX_HANDLERS）
+ *
+ * 输出分发吞吐、队列满丢弃率、发布到分发延迟的百分位数和每个处理函数的耗时；
+ * 对同一轨迹改变参数运行，可作为事件系统修改前后的性能基线。
+ *
+ * 要测试的处理函数放在单独的源文件中，实现 AolkmeReplay_RegisterHandlers() 并在配置时传入：
+ *   cmake -DAOLKME_REPLAY_HANDLERS=path/to/handlers.c ...
+ */
+
+
+#include "Aolkme_core.h"
+#include "Aolkme_event.h"
+#include "Aolkme_OSAL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+#define REPLAY_MAX_HANDLERS     8
+#define REPLAY_MAX_PUBLISHERS   16
+
+
+
+typedef struct {
+    const void *dump;
+    uint32_t size;
+    uint16_t speed;
+    T_AolkmeSemaHandle done;
+    T_AolkmeReturnCode returnCode;
+} T_ReplayPublisher;
+
+
+
+static void replayDefaultHandler(const T_AolkmeEvent *event);
+static void *replayPublisherTask(void *arg);
+static void *replayLoadFile(const char *path, uint32_t *size);
+static uint32_t replayPercentileUs(const T_AolkmeEventStats *stats, uint8_t percent);
+static void replayPrintStats(uint32_t elapsedMs);
+
+
+
+// Empty handlers subscribed by the default AolkmeReplay_RegisterHandlers
+#define REPLAY_HANDLER(n)   static void replayHandler##n(const T_AolkmeEvent *event) { (void)event; }
+REPLAY_HANDLER(1) REPLAY_HANDLER(2) REPLAY_HANDLER(3) REPLAY_HANDLER(4)
+REPLAY_HANDLER(5) REPLAY_HANDLER(6) REPLAY_HANDLER(7)
+
+static const AolkmeEventRefHandler s_replayHandlers[REPLAY_MAX_HANDLERS] = {
+    replayDefaultHandler, replayHandler1, replayHandler2, replayHandler3,
+    replayHandler4, replayHandler5, replayHandler6, replayHandler7,
+};
+
+static uint8_t s_replayHandlerCount = 1;
+
+
+
+
+
+
+
+/**
+ * @brief Subscribe the handlers to benchmark. The default subscribes the requested number of
+ * empty handlers to every event, which measures the event system alone; link a source file
+ * that defines this function to replace it.
+ */
+__attribute__((weak)) void AolkmeReplay_RegisterHandlers(void)
+{
+    for (uint8_t i = 0; i < s_replayHandlerCount; i++) {
+        AolkmeEvent_SubscribeEventRef(s_replayHandlers[i]);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        printf("usage: %s <trace.bin> [speed] [workers] [publishers] [queue_size] [handlers]\n", argv[0]);
+        return 1;
+    }
+
+    uint16_t speed = (argc > 2) ? (uint16_t)atoi(argv[2]) : 1;
+    uint8_t workers = (argc > 3) ? (uint8_t)atoi(argv[3]) : 1;
+    uint8_t publishers = (argc > 4) ? (uint8_t)atoi(argv[4]) : 1;
+    uint16_t queueSize = (argc > 5) ? (uint16_t)atoi(argv[5]) : 256;
+    s_replayHandlerCount = (argc > 6) ? (uint8_t)atoi(argv[6]) : 1;
+
+    if (publishers == 0 || publishers > REPLAY_MAX_PUBLISHERS || s_replayHandlerCount > REPLAY_MAX_HANDLERS) {
+        printf("publishers: 1..%d, handlers: 0..%d\n", REPLAY_MAX_PUBLISHERS, REPLAY_MAX_HANDLERS);
+        return 1;
+    }
+
+    uint32_t size = 0;
+    void *dump = replayLoadFile(argv[1], &size);
+    if (dump == NULL) {
+        printf("cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    T_AolkmeUserInfo userInfo = {
+        .appName = "AolkmeSDK",
+        .appId = "AolkmeReplay",
+        .appVersion = "0.1",
+    };
+
+    T_AolkmeEventSystemConfig eventConfig = {
+        .queue_size = queueSize,
+        .task_stack_size = 2048,
+        .task_priority = 5,
+        .max_handlers = 32,
+        .enable_auto_processing = true,
+        .worker_count = workers,
+    };
+
+    if (AolkmePlatform_RegOSALHandle(&g_aolkmePosixOsalHandler) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        Aolkme_Core_Init(&userInfo) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        AolkmeEvent_Init(&eventConfig) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("Aolkme init is error\n");
+        free(dump);
+        return 1;
+    }
+
+    AolkmeReplay_RegisterHandlers();
+    Aolkme_Core_Application_Start();
+
+    uint32_t startMs, endMs;
+    A_Osal_GetTimeMs(&startMs);
+
+    // Every publisher replays the whole trace, all at once
+    T_ReplayPublisher publisher[REPLAY_MAX_PUBLISHERS];
+    T_AolkmeSemaHandle done;
+    T_AolkmeTaskHandle task;
+    A_Osal_SemaphoreCreate(0, &done);
+
+    for (uint8_t i = 0; i < publishers; i++) {
+        publisher[i] = (T_ReplayPublisher) { dump, size, speed, done, AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS };
+        A_Osal_TaskCreate("ReplayPublisher", replayPublisherTask, 4096, &publisher[i], &task);
+    }
+
+    T_AolkmeReturnCode returnCode = AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+    for (uint8_t i = 0; i < publishers; i++) {
+        A_Osal_SemaphoreWait(done);
+    }
+    A_Osal_SemaphoreDestroy(done);
+
+    for (uint8_t i = 0; i < publishers; i++) {
+        if (publisher[i].returnCode != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            returnCode = publisher[i].returnCode;
+            printf("AolkmeEvent_TraceReplay is error: 0x%08X\n", (unsigned)returnCode);
+        }
+    }
+
+    // Wait for the event tasks to drain the queues
+    T_AolkmeEventStats stats;
+    do {
+        A_Osal_TaskSleepMs(1);
+        AolkmeEvent_GetStats(&stats);
+    } while (stats.queue_depth != 0);
+    A_Osal_GetTimeMs(&endMs);
+
+    replayPrintStats(endMs - startMs);
+
+    AolkmeEvent_Deinit();
+    free(dump);
+    return (returnCode == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) ? 0 : 1;
+}
+
+
+
+
+
+
+
+static void replayDefaultHandler(const T_AolkmeEvent *event)
+{
+    (void)event;
+}
+
+
+static void *replayPublisherTask(void *arg)
+{
+    T_ReplayPublisher *publisher = (T_ReplayPublisher *)arg;
+
+    publisher->returnCode = AolkmeEvent_TraceReplay(publisher->dump, publisher->size, publisher->speed);
+    A_Osal_SemaphorePost(publisher->done);
+    return NULL;
+}
+
+
+static void *replayLoadFile(const char *path, uint32_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void *data = (length > 0) ? malloc((size_t)length) : NULL;
+    if (data != NULL && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    *size = (uint32_t)length;
+    return data;
+}
+
+
+/**
+ * @brief Upper bound of the latency histogram bucket holding the given percentile.
+ */
+static uint32_t replayPercentileUs(const T_AolkmeEventStats *stats, uint8_t percent)
+{
+    uint64_t total = 0;
+    for (uint8_t i = 0; i < AOLKME_EVENT_LATENCY_BUCKETS; i++) {
+        total += stats->latency_histogram[i];
+    }
+
+    uint64_t rank = (total * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t i = 0; i < AOLKME_EVENT_LATENCY_BUCKETS; i++) {
+        seen += stats->latency_histogram[i];
+        if (seen >= rank && seen != 0) {
+            return 1UL << i;
+        }
+    }
+    return 0;
+}
+
+
+static void replayPrintStats(uint32_t elapsedMs)
+{
+    T_AolkmeEventStats stats;
+    AolkmeEvent_GetStats(&stats);
+
+    uint32_t dropped = stats.drop_queue_full + stats.drop_block_timeout + stats.drop_oldest +
+                       stats.drop_newest + stats.drop_lowest_priority;
+    uint32_t attempts = stats.publish_count + stats.drop_queue_full + stats.drop_block_timeout + stats.drop_newest;
+
+    printf("replayed %u events in %u ms (%.0f events/s)\n",
+           (unsigned)stats.dispatch_count, (unsigned)elapsedMs,
+           elapsedMs ? stats.dispatch_count * 1000.0 / elapsedMs : 0.0);
+    printf("dropped: queue full %u, invalid %u; peak queue depth %u\n",
+           (unsigned)stats.drop_queue_full, (unsigned)stats.drop_invalid, (unsigned)stats.peak_queue_depth);
+    printf("backpressure: block timeout %u, oldest %u, newest %u, lowest priority %u\n",
+           (unsigned)stats.drop_block_timeout, (unsigned)stats.drop_oldest,
+           (unsigned)stats.drop_newest, (unsigned)stats.drop_lowest_priority);
+
+    printf("queue full: %.2f%% of %u publishes, %u events dropped\n",
+           attempts ? stats.drop_queue_full * 100.0 / attempts : 0.0, (unsigned)attempts, (unsigned)dropped);
+    printf("publish to dispatch latency: p50 < %u us, p90 < %u us, p99 < %u us\n",
+           (unsigned)replayPercentileUs(&stats, 50), (unsigned)replayPercentileUs(&stats, 90),
+           (unsigned)replayPercentileUs(&stats, 99));
+    for (uint8_t i = 0; i < AOLKME_EVENT_LATENCY_BUCKETS; i++) {
+        if (stats.latency_histogram[i] != 0) {
+            printf("  < %7lu us: %u\n", 1UL << i, (unsigned)stats.latency_histogram[i]);
+        }
+    }
+
+    T_AolkmeEventHandlerStats handler;
+    for (uint16_t i = 0; AolkmeEvent_GetHandlerStats(i, &handler) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS; i++) {
+        void *function = handler.handler ? (void *)handler.handler : (void *)handler.value_handler;
+        printf("handler %p: %u calls, avg %u us, max %u us\n", function, (unsigned)handler.call_count,
+               handler.call_count ? (unsigned)(handler.total_time_us / handler.call_count) : 0u,
+               (unsigned)handler.max_time_us);
+    }
+}
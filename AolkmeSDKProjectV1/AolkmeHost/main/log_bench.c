@@ -0,0 +1,302 @@
+/**
+ * @file log_bench.c
+ * @author Aolkme
+ * @brief 主机端日志吞吐测试：连续写入若干组 1000 条日志，统计刷新任务把它们交给输出的速度
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法: aolkme_log_bench [bursts] [batch_size] [baud] [buffer_size] [sink_size]
+ *   bursts      日志组数（默认 10），每组 BENCH_BURST_LINES 条，组间空闲 BENCH_IDLE_MS
+ *   batch_size  T_AolkmeLoggerConfig.batch_size（默认 0，即 AOLKME_LOGGER_BATCH_SIZE_DEFAULT）
+ *   baud        0 = 输出不耗时（默认）；否则输出函数按 10 bit/字节的线路时间阻塞，模拟阻塞式串口发送
+ *   buffer_size 日志环形缓冲字节数（默认 8192）
+ *   sink_size   0 = 输出函数直接发送（默认）；否则输出写入 sink_size 字节的双缓冲 T_AolkmeLoggerSink，
+ *               由模拟 DMA 的线路任务按线路时间发送一半后调用 AolkmeLogger_SinkTxComplete
+ *
+ * 缓冲满时日志调用等待（AOLKME_LOGGER_OVERFLOW_WAIT），因此每组日志全部输出；
+ * 输出行/秒、字节/秒、每次发送的平均字节数、每条日志调用的平均耗时以及刷新任务在输出函数中占用的 CPU 时间
+ * （直接发送时忙等线路，双缓冲时只拷贝、等待空闲一半时睡眠）；
+ * 线路上的日志行按写入顺序逐行校验。
+ */
+
+
+#include "Aolkme_core.h"
+#include "Aolkme_logger.h"
+#include "Aolkme_OSAL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+
+#define BENCH_BURST_LINES   1000
+#define BENCH_IDLE_MS       50
+#define BENCH_LINE_MAX      256
+#define BENCH_SINK_WAIT_MS  1000
+
+
+
+static T_AolkmeReturnCode benchOutput(const uint8_t *data, uint16_t dataLen);
+static T_AolkmeReturnCode benchTransmit(const uint8_t *data, uint16_t dataLen);
+static void *benchWireTask(void *arg);
+static void benchWire(const uint8_t *data, uint16_t dataLen);
+static void benchCheckLine(const char *line);
+
+
+
+static volatile uint32_t s_benchLines = 0;
+static volatile uint32_t s_benchBytes = 0;
+static volatile uint32_t s_benchCalls = 0;
+static uint32_t s_benchBaud = 0;
+static uint64_t s_benchOutputUs = 0;                    // Flush task CPU time inside benchOutput
+
+// Line order check on the wire: "burst B line L" must follow the previous one
+static char s_benchLine[BENCH_LINE_MAX];
+static uint16_t s_benchLineLen = 0;
+static uint32_t s_benchNext = 0;
+static uint32_t s_benchBadLines = 0;
+
+// Simulated DMA: benchTransmit hands one half to the wire task
+static T_AolkmeLoggerSink s_benchSink;
+static bool s_benchSinkMode = false;
+static T_AolkmeSemaHandle s_benchWireSema = NULL;
+static const uint8_t *volatile s_benchWireData = NULL;
+static volatile uint16_t s_benchWireLen = 0;
+
+
+
+
+
+
+
+int main(int argc, char *argv[])
+{
+    uint32_t bursts = (argc > 1) ? (uint32_t)atoi(argv[1]) : 10;
+    uint16_t batchSize = (argc > 2) ? (uint16_t)atoi(argv[2]) : 0;
+    s_benchBaud = (argc > 3) ? (uint32_t)atoi(argv[3]) : 0;
+    uint16_t bufferSize = (argc > 4) ? (uint16_t)atoi(argv[4]) : 8192;
+    uint32_t sinkSize = (argc > 5) ? (uint32_t)atoi(argv[5]) : 0;
+
+    if (bursts == 0) {
+        printf("usage: %s [bursts] [batch_size] [baud] [buffer_size] [sink_size]\n", argv[0]);
+        return 1;
+    }
+
+    T_AolkmeUserInfo userInfo = {
+        .appName = "AolkmeSDK",
+        .appId = "AolkmeLogBench",
+        .appVersion = "0.1",
+    };
+
+    T_AolkmeLoggerConfig loggerConfig = {
+        .level = AOLKME_LOGGER_CONSOLE_LOG_LEVEL_INFO,
+        .isSupportColor = false,
+        .buffer_size = bufferSize,
+        .overflow = AOLKME_LOGGER_OVERFLOW_WAIT,
+        .overflow_wait_ms = 10000,
+        .batch_size = batchSize,
+    };
+
+    if (AolkmePlatform_RegOSALHandle(&g_aolkmePosixOsalHandler) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        Aolkme_Core_Init(&userInfo) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        AolkmeLogger_Init(&loggerConfig) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        AolkmeLogger_AddOutput(benchOutput) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("Aolkme init is error\n");
+        return 1;
+    }
+
+    uint8_t *sinkBuffer = NULL;
+    T_AolkmeTaskHandle wireTask = NULL;
+    if (sinkSize != 0) {
+        sinkBuffer = malloc(sinkSize);
+        if (sinkBuffer == NULL ||
+            A_Osal_SemaphoreCreate(0, &s_benchWireSema) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+            AolkmeLogger_SinkInit(&s_benchSink, sinkBuffer, sinkSize, benchTransmit, BENCH_SINK_WAIT_MS) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+            A_Osal_TaskCreate("benchwire", benchWireTask, 4096, NULL, &wireTask) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            printf("sink init is error\n");
+            return 1;
+        }
+        s_benchSinkMode = true;
+    }
+    Aolkme_Core_Application_Start();
+
+    // Core start messages are not part of the measurement
+    A_Osal_TaskSleepMs(BENCH_IDLE_MS);
+
+    uint64_t outputUs = 0;
+    uint64_t callUs = 0;
+    uint32_t lines = 0;
+    uint32_t bytes = 0;
+    uint32_t calls = 0;
+    uint64_t outputCpuUs = 0;
+
+    for (uint32_t burst = 0; burst < bursts; burst++) {
+        uint32_t startLines = s_benchLines;
+        uint32_t startBytes = s_benchBytes;
+        uint32_t startCalls = s_benchCalls;
+        uint64_t startOutputCpuUs = s_benchOutputUs;
+        uint32_t startUs, loggedUs, endUs;
+
+        A_Osal_GetTimeUs(&startUs);
+        for (uint32_t i = 0; i < BENCH_BURST_LINES; i++) {
+            ALOG_INFO("bench", "burst %u line %u value 0x%08x", (unsigned)burst, (unsigned)i, (unsigned)(i * 2654435761u));
+        }
+        A_Osal_GetTimeUs(&loggedUs);
+
+        // Every line of the burst handed to the output
+        while (s_benchLines - startLines < BENCH_BURST_LINES) {
+            A_Osal_TaskSleepMs(1);
+        }
+        A_Osal_GetTimeUs(&endUs);
+
+        outputUs += endUs - startUs;
+        callUs += loggedUs - startUs;
+        lines += s_benchLines - startLines;
+        bytes += s_benchBytes - startBytes;
+        calls += s_benchCalls - startCalls;
+        outputCpuUs += s_benchOutputUs - startOutputCpuUs;
+
+        A_Osal_TaskSleepMs(BENCH_IDLE_MS);
+    }
+
+    T_AolkmeLoggerStats stats;
+    AolkmeLogger_GetStats(&stats);
+
+    double seconds = (double)outputUs / 1e6;
+    printf("%u bursts of %u lines, batch_size %u, baud %u, buffer %u bytes, sink %u bytes\n",
+           (unsigned)bursts, BENCH_BURST_LINES, (unsigned)batchSize, (unsigned)s_benchBaud, (unsigned)bufferSize,
+           (unsigned)sinkSize);
+    printf("  lines/s      %.0f\n", lines / seconds);
+    printf("  bytes/s      %.0f\n", bytes / seconds);
+    printf("  transfers    %u (%.1f bytes/transfer)\n", (unsigned)calls, calls ? (double)bytes / calls : 0.0);
+    printf("  log call     %.2f us\n", (double)callUs / lines);
+    printf("  output cpu   %.1f%% of the run\n", 100.0 * (double)outputCpuUs / (double)outputUs);
+    printf("  dropped      %u, buffer peak %u bytes\n", (unsigned)stats.drop_buffer_full, (unsigned)stats.buffer_peak);
+    printf("  order errors %u\n", (unsigned)s_benchBadLines);
+    if (s_benchSinkMode) {
+        printf("  sink         %u write waits, %u bytes dropped\n",
+               (unsigned)s_benchSink.write_waits, (unsigned)s_benchSink.dropped_bytes);
+    }
+
+    AolkmeLogger_Deinit();
+    if (s_benchSinkMode) {
+        AolkmeLogger_SinkFlush(&s_benchSink, BENCH_SINK_WAIT_MS);
+        A_Osal_TaskDestroy(wireTask);
+        AolkmeLogger_SinkDeinit(&s_benchSink);
+        A_Osal_SemaphoreDestroy(s_benchWireSema);
+        free(sinkBuffer);
+    }
+    return (s_benchBadLines == 0) ? 0 : 1;
+}
+
+
+
+
+
+
+
+/**
+ * @brief Logger output: the sink, or the wire itself (blocking for the wire time like a polled UART).
+ */
+static T_AolkmeReturnCode benchOutput(const uint8_t *data, uint16_t dataLen)
+{
+    struct timespec start, end;
+    T_AolkmeReturnCode returncode = AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+    if (s_benchSinkMode) {
+        returncode = AolkmeLogger_SinkWrite(&s_benchSink, data, dataLen);
+    } else {
+        benchWire(data, dataLen);
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+
+    s_benchOutputUs += (uint64_t)((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000);
+    return returncode;
+}
+
+
+/**
+ * @brief Sink transmit: start the simulated DMA on one half.
+ */
+static T_AolkmeReturnCode benchTransmit(const uint8_t *data, uint16_t dataLen)
+{
+    s_benchWireData = data;
+    s_benchWireLen = dataLen;
+    return A_Osal_SemaphorePost(s_benchWireSema);
+}
+
+
+/**
+ * @brief Simulated DMA and UART: send the half, then report completion like the TX complete interrupt.
+ */
+static void *benchWireTask(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        if (A_Osal_SemaphoreWait(s_benchWireSema) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            continue;
+        }
+        benchWire(s_benchWireData, s_benchWireLen);
+        AolkmeLogger_SinkTxComplete(&s_benchSink, NULL);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Bytes on the wire: take the wire time at the baud rate, count and check the lines.
+ */
+static void benchWire(const uint8_t *data, uint16_t dataLen)
+{
+    uint32_t lines = 0;
+
+    for (uint16_t i = 0; i < dataLen; i++) {
+        if (data[i] != '\n') {
+            if (s_benchLineLen < BENCH_LINE_MAX - 1) {
+                s_benchLine[s_benchLineLen++] = (char)data[i];
+            }
+            continue;
+        }
+        s_benchLine[s_benchLineLen] = '\0';
+        benchCheckLine(s_benchLine);
+        s_benchLineLen = 0;
+        lines++;
+    }
+
+    if (s_benchBaud != 0) {
+        uint32_t startUs, nowUs;
+        uint32_t wireUs = (uint32_t)((uint64_t)dataLen * 10 * 1000000 / s_benchBaud);
+        A_Osal_GetTimeUs(&startUs);
+        do {
+            A_Osal_GetTimeUs(&nowUs);
+        } while (nowUs - startUs < wireUs);
+    }
+
+    s_benchCalls++;
+    s_benchBytes += dataLen;
+    s_benchLines += lines;
+}
+
+
+/**
+ * @brief Benchmark lines must arrive whole and in the order they were logged.
+ */
+static void benchCheckLine(const char *line)
+{
+    const char *text = strstr(line, "burst ");
+    unsigned burst, index;
+
+    if (text == NULL) {
+        return;
+    }
+    if (sscanf(text, "burst %u line %u", &burst, &index) != 2 || strstr(text, "value 0x") == NULL ||
+        burst * BENCH_BURST_LINES + index != s_benchNext) {
+        s_benchBadLines++;
+    }
+    s_benchNext = burst * BENCH_BURST_LINES + index + 1;
+}
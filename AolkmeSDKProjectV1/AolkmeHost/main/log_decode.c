@@ -0,0 +1,336 @@
+/**
+ * @file log_decode.c
+ * @author Aolkme
+ * @brief 主机端延迟日志解码：从固件 ELF 的 .aolkme_logstr 段读取调用点字符串，
+ *        把设备输出的二进制日志帧（ALOG_DEFER）还原为与 AolkmeLogger_FormatterFormat 相同格式的文本
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法: aolkme_log_decode <firmware.elf> [capture.bin]
+ *   firmware.elf 产生日志的固件（ELF32 或 ELF64），段地址须与运行地址一致
+ *   capture.bin  串口等输出的原始字节，缺省读标准输入
+ *
+ * 不是帧的字节（普通文本日志、printf）原样输出，解码器在下一个有效帧处重新同步。
+ * 帧序号不连续时输出丢失的帧数。
+ */
+
+
+#include "Aolkme_logger.h"
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+typedef struct {
+    uint64_t addr;
+    uint64_t size;
+    char *data;
+} T_DecodeStrings;
+
+
+
+static const char *LEVEL_STRINGS[] = { "FATAL", "ERROR", "WARN", "INFO", "DEBUG", "TRACE" };
+
+
+
+static int decodeLoadStrings(const char *path, T_DecodeStrings *strings);
+static const char *decodeString(const T_DecodeStrings *strings, uint32_t addr);
+static const T_AolkmeLoggerDeferFrame *decodeFrame(const T_DecodeStrings *strings, const uint8_t *data, size_t size);
+static void decodePrint(const T_DecodeStrings *strings, const T_AolkmeLoggerDeferFrame *frame);
+static void decodeFormat(const T_DecodeStrings *strings, const char *format, const uint32_t *args, uint8_t argc);
+
+
+
+
+
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s <firmware.elf> [capture.bin]\n", argv[0]);
+        return 1;
+    }
+
+    T_DecodeStrings strings;
+    if (decodeLoadStrings(argv[1], &strings) != 0) {
+        return 1;
+    }
+
+    FILE *in = (argc > 2) ? fopen(argv[2], "rb") : stdin;
+    if (in == NULL) {
+        printf("cannot read %s\n", argv[2]);
+        free(strings.data);
+        return 1;
+    }
+
+    // Whole capture in memory, frames are looked up at every offset
+    size_t size = 0;
+    size_t capacity = 4096;
+    uint8_t *capture = malloc(capacity);
+    size_t n;
+    while (capture != NULL && (n = fread(capture + size, 1, capacity - size, in)) > 0) {
+        size += n;
+        if (size == capacity) {
+            capacity *= 2;
+            capture = realloc(capture, capacity);
+        }
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    uint32_t frames = 0;
+    uint32_t lost = 0;
+    int next_seq = -1;
+    size_t pos = 0;
+    while (capture != NULL && pos < size) {
+        const T_AolkmeLoggerDeferFrame *frame = decodeFrame(&strings, capture + pos, size - pos);
+        if (frame == NULL) {
+            putchar(capture[pos++]);
+            continue;
+        }
+
+        if (next_seq >= 0 && frame->seq != (uint8_t)next_seq) {
+            uint8_t gap = (uint8_t)(frame->seq - next_seq);
+            printf("[%u log frames lost]\n", gap);
+            lost += gap;
+        }
+        next_seq = (uint8_t)(frame->seq + 1);
+
+        decodePrint(&strings, frame);
+        frames++;
+        pos += sizeof(T_AolkmeLoggerDeferFrame) + frame->argc * sizeof(uint32_t);
+    }
+
+    fprintf(stderr, "%u frames decoded, %u lost\n", frames, lost);
+    free(capture);
+    free(strings.data);
+    return 0;
+}
+
+
+
+
+
+
+/**
+ * @brief Read the address and contents of AOLKME_LOGGER_DEFER_SECTION.
+ */
+static int decodeLoadStrings(const char *path, T_DecodeStrings *strings)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("cannot read %s\n", path);
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *elf = malloc((size_t)size);
+    if (elf == NULL || fread(elf, 1, (size_t)size, file) != (size_t)size || size < EI_NIDENT ||
+        memcmp(elf, ELFMAG, SELFMAG) != 0) {
+        printf("%s is not an ELF file\n", path);
+        fclose(file);
+        free(elf);
+        return -1;
+    }
+    fclose(file);
+
+    // Section headers and their name table, both ELF classes
+    bool is64 = (elf[EI_CLASS] == ELFCLASS64);
+    uint64_t shoff = is64 ? ((Elf64_Ehdr *)elf)->e_shoff : ((Elf32_Ehdr *)elf)->e_shoff;
+    uint16_t shnum = is64 ? ((Elf64_Ehdr *)elf)->e_shnum : ((Elf32_Ehdr *)elf)->e_shnum;
+    uint16_t shstrndx = is64 ? ((Elf64_Ehdr *)elf)->e_shstrndx : ((Elf32_Ehdr *)elf)->e_shstrndx;
+    size_t shentsize = is64 ? sizeof(Elf64_Shdr) : sizeof(Elf32_Shdr);
+
+    memset(strings, 0, sizeof(*strings));
+    if (shoff + (uint64_t)shnum * shentsize > (uint64_t)size || shstrndx >= shnum) {
+        printf("%s: bad section table\n", path);
+        free(elf);
+        return -1;
+    }
+
+#define SECTION(i, field) (is64 ? (uint64_t)((Elf64_Shdr *)(elf + shoff + (i) * shentsize))->field \
+                                : (uint64_t)((Elf32_Shdr *)(elf + shoff + (i) * shentsize))->field)
+
+    const char *names = (const char *)elf + SECTION(shstrndx, sh_offset);
+    for (uint16_t i = 0; i < shnum; i++) {
+        if (strcmp(names + SECTION(i, sh_name), AOLKME_LOGGER_DEFER_SECTION) != 0) {
+            continue;
+        }
+
+        strings->addr = SECTION(i, sh_addr);
+        strings->size = SECTION(i, sh_size);
+        strings->data = malloc(strings->size + 1);
+        if (strings->data != NULL && SECTION(i, sh_type) != SHT_NOBITS &&
+            SECTION(i, sh_offset) + strings->size <= (uint64_t)size) {
+            memcpy(strings->data, elf + SECTION(i, sh_offset), strings->size);
+            strings->data[strings->size] = '\0';
+        }
+        break;
+    }
+
+#undef SECTION
+
+    free(elf);
+    if (strings->data == NULL) {
+        printf("%s: no %s section with contents\n", path, AOLKME_LOGGER_DEFER_SECTION);
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief String at a target address in the section, NULL if outside it.
+ */
+static const char *decodeString(const T_DecodeStrings *strings, uint32_t addr)
+{
+    if (addr < strings->addr || addr >= strings->addr + strings->size) {
+        return NULL;
+    }
+    return strings->data + (addr - strings->addr);
+}
+
+
+/**
+ * @brief The frame at data, NULL if these bytes are not a complete valid frame.
+ */
+static const T_AolkmeLoggerDeferFrame *decodeFrame(const T_DecodeStrings *strings, const uint8_t *data, size_t size)
+{
+    static T_AolkmeLoggerDeferFrame *frame = NULL;
+
+    if (frame == NULL) {
+        frame = malloc(sizeof(T_AolkmeLoggerDeferFrame) + AOLKME_LOGGER_DEFER_MAX_ARGS * sizeof(uint32_t));
+    }
+
+    if (size < sizeof(T_AolkmeLoggerDeferFrame) || data[0] != AOLKME_LOGGER_DEFER_MAGIC) {
+        return NULL;
+    }
+
+    // Unaligned in the capture: copy before reading the words
+    memcpy(frame, data, sizeof(T_AolkmeLoggerDeferFrame));
+    if (frame->level >= AOLKME_LOGGER_CONSOLE_LOG_LEVEL_MAX || frame->argc > AOLKME_LOGGER_DEFER_MAX_ARGS ||
+        decodeString(strings, frame->id) == NULL ||
+        size < sizeof(T_AolkmeLoggerDeferFrame) + frame->argc * sizeof(uint32_t)) {
+        return NULL;
+    }
+
+    memcpy(frame->args, data + sizeof(T_AolkmeLoggerDeferFrame), frame->argc * sizeof(uint32_t));
+    return frame;
+}
+
+
+/**
+ * @brief Print one frame like the target's text formatter: time-[LEVEL-][tag]-file:line ->> :message
+ */
+static void decodePrint(const T_DecodeStrings *strings, const T_AolkmeLoggerDeferFrame *frame)
+{
+    const char *end = strings->data + strings->size;
+    const char *tag = decodeString(strings, frame->id);
+    const char *location = tag + strlen(tag) + 1;
+    const char *format = (location < end) ? location + strlen(location) + 1 : end;
+    if (location >= end || format >= end) {
+        printf("[bad log string 0x%08x]\n", frame->id);
+        return;
+    }
+
+    const char *base_file = strrchr(location, '/');
+    if (base_file == NULL) {
+        base_file = strrchr(location, '\\');
+    }
+    base_file = base_file ? base_file + 1 : location;
+
+    printf("%6u-[%s-]", frame->timestamp, LEVEL_STRINGS[frame->level]);
+    if (*tag) {
+        printf("[%s]", tag);
+    }
+    printf("-%s ->> :", base_file);
+    decodeFormat(strings, format, frame->args, frame->argc);
+    printf("\n");
+}
+
+
+/**
+ * @brief printf with 32-bit argument words: each conversion takes the next word.
+ */
+static void decodeFormat(const T_DecodeStrings *strings, const char *format, const uint32_t *args, uint8_t argc)
+{
+    uint8_t next = 0;
+
+    while (*format) {
+        if (*format != '%') {
+            putchar(*format++);
+            continue;
+        }
+        if (format[1] == '%') {
+            putchar('%');
+            format += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision; length modifiers are dropped, every argument is 32 bits
+        char spec[32];
+        size_t len = 0;
+        spec[len++] = *format++;
+        while (*format && strchr("-+ #0123456789.*hlLqjzt", *format) && len < sizeof(spec) - 3) {
+            if (*format == '*') {
+                // Room is kept for the conversion and the terminator; a truncated number is cut there
+                int written = snprintf(spec + len, sizeof(spec) - 2 - len, "%d", (next < argc) ? (int32_t)args[next++] : 0);
+                if (written > 0) {
+                    len += ((size_t)written < sizeof(spec) - 2 - len) ? (size_t)written : sizeof(spec) - 3 - len;
+                }
+            } else if (!strchr("hlLqjzt", *format)) {
+                spec[len++] = *format;
+            }
+            format++;
+        }
+        char conversion = *format ? *format++ : '\0';
+        uint32_t word = (next < argc) ? args[next++] : 0;
+
+        switch (conversion) {
+            case 'd':
+            case 'i':
+                spec[len++] = conversion;
+                spec[len] = '\0';
+                printf(spec, (int)(int32_t)word);
+                break;
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c':
+                spec[len++] = conversion;
+                spec[len] = '\0';
+                printf(spec, (unsigned int)word);
+                break;
+
+            case 'p':
+                printf("0x%08x", word);
+                break;
+
+            case 's': {
+                const char *text = decodeString(strings, word);
+                spec[len++] = 's';
+                spec[len] = '\0';
+                if (text != NULL) {
+                    printf(spec, text);
+                } else {
+                    printf("<0x%08x>", word);
+                }
+                break;
+            }
+
+            default:
+                // Floats and unknown conversions cannot be rebuilt from one word
+                printf("<%c?>", conversion ? conversion : '%');
+                break;
+        }
+    }
+}
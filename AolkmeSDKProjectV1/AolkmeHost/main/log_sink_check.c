@@ -0,0 +1,357 @@
+/**
+ * @file log_sink_check.c
+ * @author Aolkme
+ * @brief 主机端双缓冲输出（T_AolkmeLoggerSink）检查：用模拟的发送函数覆盖正常发送和各种异常路径
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法: aolkme_log_sink_check
+ *
+ * 依次检查：
+ *   wire     模拟 DMA 的线路任务在发送完成后调用 AolkmeLogger_SinkTxComplete，线路上的字节与写入一致
+ *   timeout  发送一直不完成时写入等待 wait_ms 后丢弃剩余数据并返回 NO_RESOURCE
+ *   fail     transmit 返回错误时该半缓冲计入 dropped_bytes，之后的写入照常发送
+ *   sync     transmit 内部直接调用 AolkmeLogger_SinkTxComplete（发送立即完成）
+ *   flush    AolkmeLogger_SinkFlush 等到两半都发送完；发送不完成时超时返回
+ * 全部通过时返回 0。
+ */
+
+
+#include "Aolkme_logger.h"
+#include "Aolkme_OSAL.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+#define CHECK_SINK_SIZE         64
+#define CHECK_WAIT_MS           50
+#define CHECK_WIRE_MAX          (64 * 1024)
+
+
+
+typedef enum {
+    CHECK_WIRE_TASK = 0,                // The wire task sends, then reports completion like the TX complete interrupt
+    CHECK_WIRE_STALL,                   // Takes the data, never completes until checkComplete()
+    CHECK_WIRE_FAIL,                    // Refuses every transfer
+    CHECK_WIRE_SYNC,                    // Completes inside transmit
+} E_CheckWire;
+
+
+
+static T_AolkmeReturnCode checkTransmit(const uint8_t *data, uint16_t dataLen);
+static void *checkWireTask(void *arg);
+static void checkWire(const uint8_t *data, uint16_t dataLen);
+static void checkComplete(void);
+static void checkStart(E_CheckWire wire);
+static bool checkResult(const char *name, bool ok);
+static bool checkOutput(const uint8_t *expect, uint32_t length);
+static void checkPattern(uint8_t *data, uint32_t length, uint32_t seed);
+
+static bool checkWireOrder(void);
+static bool checkWaitTimeout(void);
+static bool checkTransmitFail(void);
+static bool checkSyncComplete(void);
+static bool checkFlush(void);
+
+
+
+static T_AolkmeLoggerSink s_checkSink;
+static uint8_t s_checkSinkBuffer[CHECK_SINK_SIZE];
+static volatile E_CheckWire s_checkWire = CHECK_WIRE_TASK;
+static volatile uint32_t s_checkWireDelayMs = 0;
+
+// Simulated DMA: checkTransmit hands one half to the wire task
+static T_AolkmeSemaHandle s_checkWireSema = NULL;
+static const uint8_t *volatile s_checkWireData = NULL;
+static volatile uint16_t s_checkWireLen = 0;
+
+// Bytes that reached the wire, in order
+static uint8_t s_checkOutput[CHECK_WIRE_MAX];
+static volatile uint32_t s_checkOutputLen = 0;
+static volatile uint32_t s_checkTransmits = 0;
+
+
+
+
+
+
+
+int main(void)
+{
+    T_AolkmeTaskHandle wireTask;
+
+    if (AolkmePlatform_RegOSALHandle(&g_aolkmePosixOsalHandler) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        A_Osal_SemaphoreCreate(0, &s_checkWireSema) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS ||
+        A_Osal_TaskCreate("checkwire", checkWireTask, 4096, NULL, &wireTask) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+        printf("check init is error\n");
+        return 1;
+    }
+
+    bool ok = checkWireOrder();
+    ok = checkWaitTimeout() && ok;
+    ok = checkTransmitFail() && ok;
+    ok = checkSyncComplete() && ok;
+    ok = checkFlush() && ok;
+
+    A_Osal_TaskDestroy(wireTask);
+    A_Osal_SemaphoreDestroy(s_checkWireSema);
+    printf(ok ? "all checks passed\n" : "checks FAILED\n");
+    return ok ? 0 : 1;
+}
+
+
+
+
+
+
+
+/**
+ * @brief Random sized writes through the wire task arrive whole and in order.
+ */
+static bool checkWireOrder(void)
+{
+    static uint8_t expect[CHECK_WIRE_MAX];
+    uint32_t total = 0;
+    bool ok = true;
+
+    checkStart(CHECK_WIRE_TASK);
+    srand(1);
+    while (ok && total < sizeof(expect) - 300) {
+        uint16_t n = (uint16_t)(rand() % 300 + 1);
+        checkPattern(expect + total, n, total);
+        ok = AolkmeLogger_SinkWrite(&s_checkSink, expect + total, n) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+        total += n;
+    }
+
+    ok = ok && AolkmeLogger_SinkFlush(&s_checkSink, 1000) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+              checkOutput(expect, total) && s_checkSink.bytes_sent == total && s_checkSink.dropped_bytes == 0;
+    ok = checkResult("wire", ok);
+    AolkmeLogger_SinkDeinit(&s_checkSink);
+    return ok;
+}
+
+
+/**
+ * @brief Both halves busy for longer than wait_ms: the rest of the write is dropped.
+ */
+static bool checkWaitTimeout(void)
+{
+    uint8_t data[CHECK_SINK_SIZE + 10];
+    uint32_t startMs, endMs;
+
+    checkStart(CHECK_WIRE_STALL);
+    checkPattern(data, sizeof(data), 0);
+
+    // First half on the wire, second half filled, 10 bytes left over
+    A_Osal_GetTimeMs(&startMs);
+    T_AolkmeReturnCode returnCode = AolkmeLogger_SinkWrite(&s_checkSink, data, sizeof(data));
+    A_Osal_GetTimeMs(&endMs);
+
+    bool ok = returnCode == AOLKME_ERROR_LOGGER_MODULE_CODE_NO_RESOURCE &&
+              endMs - startMs >= CHECK_WAIT_MS && s_checkSink.write_waits == 1 && s_checkSink.dropped_bytes == 10;
+
+    // The stalled transfers complete: what was kept goes out
+    checkComplete();
+    checkComplete();
+    ok = ok && AolkmeLogger_SinkFlush(&s_checkSink, 100) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+         checkOutput(data, CHECK_SINK_SIZE) && s_checkSink.bytes_sent == CHECK_SINK_SIZE;
+    ok = checkResult("timeout", ok);
+    AolkmeLogger_SinkDeinit(&s_checkSink);
+    return ok;
+}
+
+
+/**
+ * @brief A refused transfer drops its half and leaves the sink idle for the next write.
+ */
+static bool checkTransmitFail(void)
+{
+    uint8_t data[20];
+
+    checkStart(CHECK_WIRE_FAIL);
+    checkPattern(data, sizeof(data), 0);
+
+    bool ok = AolkmeLogger_SinkWrite(&s_checkSink, data, sizeof(data)) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+              s_checkTransmits == 1 && s_checkSink.dropped_bytes == sizeof(data) && s_checkSink.in_flight == 0 &&
+              AolkmeLogger_SinkFlush(&s_checkSink, 100) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+
+    s_checkWire = CHECK_WIRE_TASK;
+    checkPattern(data, sizeof(data), 100);
+    ok = ok && AolkmeLogger_SinkWrite(&s_checkSink, data, sizeof(data)) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+         AolkmeLogger_SinkFlush(&s_checkSink, 1000) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+         checkOutput(data, sizeof(data)) && s_checkSink.dropped_bytes == sizeof(data);
+    ok = checkResult("fail", ok);
+    AolkmeLogger_SinkDeinit(&s_checkSink);
+    return ok;
+}
+
+
+/**
+ * @brief A transmit that completes at once calls TxComplete from inside SinkStart.
+ */
+static bool checkSyncComplete(void)
+{
+    static uint8_t expect[CHECK_WIRE_MAX / 4];
+    uint32_t total = 0;
+
+    checkStart(CHECK_WIRE_SYNC);
+    srand(2);
+    while (total < sizeof(expect) - 100) {
+        uint16_t n = (uint16_t)(rand() % 100 + 1);
+        checkPattern(expect + total, n, total);
+        AolkmeLogger_SinkWrite(&s_checkSink, expect + total, n);
+        total += n;
+    }
+
+    // Nothing may be left on the wire or in the fill half: a flush without waiting succeeds
+    bool ok = AolkmeLogger_SinkFlush(&s_checkSink, 0) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+              checkOutput(expect, total) && s_checkSink.transfers == s_checkTransmits &&
+              s_checkSink.bytes_sent == total && s_checkSink.write_waits == 0 && s_checkSink.dropped_bytes == 0;
+    ok = checkResult("sync", ok);
+    AolkmeLogger_SinkDeinit(&s_checkSink);
+    return ok;
+}
+
+
+/**
+ * @brief Flush sends the fill half after the transfer on the wire, or times out if it never ends.
+ */
+static bool checkFlush(void)
+{
+    uint8_t data[CHECK_SINK_SIZE / 2 + 8];
+    uint32_t startMs, endMs;
+
+    // One half on a slow wire, 8 bytes waiting in the other one
+    checkStart(CHECK_WIRE_TASK);
+    s_checkWireDelayMs = 20;
+    checkPattern(data, sizeof(data), 0);
+    AolkmeLogger_SinkWrite(&s_checkSink, data, sizeof(data));
+
+    bool ok = AolkmeLogger_SinkFlush(&s_checkSink, 1000) == AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS &&
+              checkOutput(data, sizeof(data)) && s_checkSink.transfers == 2;
+    s_checkWireDelayMs = 0;
+    AolkmeLogger_SinkDeinit(&s_checkSink);
+
+    checkStart(CHECK_WIRE_STALL);
+    AolkmeLogger_SinkWrite(&s_checkSink, data, sizeof(data));
+    A_Osal_GetTimeMs(&startMs);
+    ok = ok && AolkmeLogger_SinkFlush(&s_checkSink, CHECK_WAIT_MS) == AOLKME_ERROR_SYSTEM_MODULE_CODE_TIMEOUT;
+    A_Osal_GetTimeMs(&endMs);
+    ok = ok && endMs - startMs >= CHECK_WAIT_MS;
+    checkComplete();
+    checkComplete();
+    ok = checkResult("flush", ok);
+    AolkmeLogger_SinkDeinit(&s_checkSink);
+    return ok;
+}
+
+
+
+
+
+
+
+/**
+ * @brief Fresh sink and wire for one check.
+ */
+static void checkStart(E_CheckWire wire)
+{
+    s_checkWire = wire;
+    s_checkOutputLen = 0;
+    s_checkTransmits = 0;
+    AolkmeLogger_SinkInit(&s_checkSink, s_checkSinkBuffer, sizeof(s_checkSinkBuffer), checkTransmit, CHECK_WAIT_MS);
+}
+
+
+static T_AolkmeReturnCode checkTransmit(const uint8_t *data, uint16_t dataLen)
+{
+    s_checkTransmits++;
+
+    switch (s_checkWire) {
+        case CHECK_WIRE_FAIL:
+            return AOLKME_ERROR_SYSTEM_MODULE_CODE_UNKNOWN;
+
+        case CHECK_WIRE_SYNC:
+            checkWire(data, dataLen);
+            AolkmeLogger_SinkTxComplete(&s_checkSink, NULL);
+            return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+
+        case CHECK_WIRE_STALL:
+            checkWire(data, dataLen);
+            return AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS;
+
+        default:
+            s_checkWireData = data;
+            s_checkWireLen = dataLen;
+            return A_Osal_SemaphorePost(s_checkWireSema);
+    }
+}
+
+
+/**
+ * @brief Simulated DMA and UART: send the half, then report completion like the TX complete interrupt.
+ */
+static void *checkWireTask(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        if (A_Osal_SemaphoreWait(s_checkWireSema) != AOLKME_ERROR_SYSTEM_MODULE_CODE_SUCCESS) {
+            continue;
+        }
+        if (s_checkWireDelayMs != 0) {
+            A_Osal_TaskSleepMs(s_checkWireDelayMs);
+        }
+        checkWire(s_checkWireData, s_checkWireLen);
+        AolkmeLogger_SinkTxComplete(&s_checkSink, NULL);
+    }
+    return NULL;
+}
+
+
+static void checkWire(const uint8_t *data, uint16_t dataLen)
+{
+    if (s_checkOutputLen + dataLen <= sizeof(s_checkOutput)) {
+        memcpy(s_checkOutput + s_checkOutputLen, data, dataLen);
+        s_checkOutputLen += dataLen;
+    }
+}
+
+
+/**
+ * @brief End a stalled transfer, like a late TX complete interrupt.
+ */
+static void checkComplete(void)
+{
+    AolkmeLogger_SinkTxComplete(&s_checkSink, NULL);
+}
+
+
+static bool checkResult(const char *name, bool ok)
+{
+    printf("%-8s %s: %u transfers, %u bytes sent, %u write waits, %u bytes dropped\n", name, ok ? "ok" : "FAIL",
+           (unsigned)s_checkSink.transfers, (unsigned)s_checkSink.bytes_sent,
+           (unsigned)s_checkSink.write_waits, (unsigned)s_checkSink.dropped_bytes);
+    return ok;
+}
+
+
+static bool checkOutput(const uint8_t *expect, uint32_t length)
+{
+    return s_checkOutputLen == length && memcmp(s_checkOutput, expect, length) == 0;
+}
+
+
+/**
+ * @brief Bytes that differ from their neighbours, so a lost or repeated byte shows up.
+ */
+static void checkPattern(uint8_t *data, uint32_t length, uint32_t seed)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)((seed + i) * 131u + ((seed + i) >> 8));
+    }
+}